@@ -107,7 +107,32 @@ struct Ray {
             tmin = tzmin;
         if (tzmax < tmax)
             tmax = tzmax;
-        t = tmin;
-        return tmin >= 0.0;
+        if (tmax < 0.0)
+            return false;
+        // Origin inside the box counts as a hit at t = 0
+        t = tmin > 0.0 ? tmin : 0.0;
+        return true;
+    }
+
+    // Moller-Trumbore, sin culling de caras traseras. u, v: baricentricas del hit
+    bool intersectsTriangle(const vec3& v0, const vec3& v1, const vec3& v2, double& t, double& u, double& v) const {
+        const double kEpsilon = 1e-12;
+        vec3 edge1 = v1 - v0;
+        vec3 edge2 = v2 - v0;
+        vec3 pvec = glm::cross(direction, edge2);
+        double det = glm::dot(edge1, pvec);
+        if (det > -kEpsilon && det < kEpsilon) return false; // Paralelo al triangulo
+        double invDet = 1.0 / det;
+
+        vec3 tvec = origin - v0;
+        u = glm::dot(tvec, pvec) * invDet;
+        if (u < 0.0 || u > 1.0) return false;
+
+        vec3 qvec = glm::cross(tvec, edge1);
+        v = glm::dot(direction, qvec) * invDet;
+        if (v < 0.0 || u + v > 1.0) return false;
+
+        t = glm::dot(edge2, qvec) * invDet;
+        return t >= 0.0;
     }
 };
\ No newline at end of file
@@ -1,11 +1,61 @@
 #include "AssetDatabase.h"
 #include "Logger.h"
+#include "ModelLoader.h"
+#include "Hash.h"
+#include "JobSystem.h"
 #include <filesystem>
 #include <fstream>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 
 namespace fs = std::filesystem;
 
+// Los artefactos que se copian tal cual guardan su clave al lado
+static std::string keyFilePath(const AssetMeta& meta) {
+    return meta.libraryPath + ".key";
+}
+
+static uint64_t readKeyFile(const std::string& path) {
+    std::ifstream in(path);
+    uint64_t key = 0;
+    if (!(in >> std::hex >> key)) return 0;
+    return key;
+}
+
+static bool writeKeyFile(const std::string& path, uint64_t key) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) return false;
+    out << std::hex << key << "\n";
+    return (bool)out;
+}
+
+// Lo que edita el inspector de assets; el resto del meta lo escribe la importacion
+static void copyImportSettings(AssetMeta& to, const AssetMeta& from) {
+    to.texMinFilter = from.texMinFilter;
+    to.texMagFilter = from.texMagFilter;
+    to.texWrapS = from.texWrapS;
+    to.texWrapT = from.texWrapT;
+    to.texFlipX = from.texFlipX;
+    to.texFlipY = from.texFlipY;
+    to.texMipmaps = from.texMipmaps;
+    to.meshScale = from.meshScale;
+    to.axisUp = from.axisUp;
+    to.axisForward = from.axisForward;
+    to.ignoreCameras = from.ignoreCameras;
+    to.ignoreLights = from.ignoreLights;
+}
+
+struct AssetDatabase::ImportBatch {
+    std::vector<AssetMeta> metas;   // Ordenados por sourcePath
+    std::vector<char> imported;     // Por hueco, para el resumen del log
+    std::atomic<size_t> next{ 0 };
+    std::atomic<size_t> done{ 0 };
+    std::mutex mtx;
+    std::condition_variable cv;
+};
+
 AssetDatabase& AssetDatabase::instance() {
     static AssetDatabase inst;
     return inst;
@@ -26,6 +76,10 @@ void AssetDatabase::initialize(const std::string& assetsPath, const std::string&
 }
 
 void AssetDatabase::shutdown() {
+    if (batch_) waitImport(*batch_);
+    batch_.reset();
+    refreshQueued_ = false;
+    editedDuringImport_.clear();
     assets_.clear();
     guid_to_index_.clear();
     path_to_index_.clear();
@@ -33,14 +87,114 @@ void AssetDatabase::shutdown() {
 }
 
 void AssetDatabase::refresh() {
+    // Un refresh asincrono a medias se termina primero: su resultado ya no vale
+    if (batch_) {
+        waitImport(*batch_);
+        batch_.reset();
+    }
+    refreshQueued_ = false;
+
+    batch_ = startImport();
+    runImport(*batch_);  // El hilo principal tambien importa
+    waitImport(*batch_);
+    finishImport();
+}
+
+void AssetDatabase::refreshAsync() {
+    if (batch_) {
+        refreshQueued_ = true;
+        return;
+    }
+    batch_ = startImport();
+}
+
+void AssetDatabase::pollImport() {
+    if (!batch_ || batch_->done.load() < batch_->metas.size()) return;
+    finishImport();
+    if (refreshQueued_) {
+        refreshQueued_ = false;
+        refreshAsync();
+    }
+}
+
+void AssetDatabase::importProgress(size_t& done, size_t& total) const {
+    done = batch_ ? batch_->done.load() : 0;
+    total = batch_ ? batch_->metas.size() : 0;
+}
+
+std::shared_ptr<AssetDatabase::ImportBatch> AssetDatabase::startImport() {
+    LOG_INFO("AssetDatabase: Scanning Assets folder...");
+    auto batch = std::make_shared<ImportBatch>();
+    batch->metas = scanAssetsFolder();
+    batch->imported.assign(batch->metas.size(), 0);
+
+    // Un trabajo por worker; cada uno va cogiendo assets de uno en uno, que un
+    // FBX grande cuesta mucho mas que copiar una textura
+    if (!batch->metas.empty()) {
+        JobSystem& jobs = JobSystem::instance();
+        for (size_t i = 0; i < jobs.workerCount(); ++i)
+            jobs.submit([this, batch] { runImport(*batch); });
+    }
+    return batch;
+}
+
+void AssetDatabase::runImport(ImportBatch& batch) {
+    const size_t count = batch.metas.size();
+    for (size_t i = batch.next.fetch_add(1); i < count; i = batch.next.fetch_add(1)) {
+        batch.imported[i] = processAsset(batch.metas[i]) ? 1 : 0;
+        if (batch.done.fetch_add(1) + 1 == count) {
+            std::lock_guard<std::mutex> lock(batch.mtx);
+            batch.cv.notify_all();
+        }
+    }
+}
+
+void AssetDatabase::waitImport(ImportBatch& batch) {
+    std::unique_lock<std::mutex> lock(batch.mtx);
+    batch.cv.wait(lock, [&] { return batch.done.load() == batch.metas.size(); });
+}
+
+void AssetDatabase::finishImport() {
+    std::shared_ptr<ImportBatch> batch = std::move(batch_);
+    // Las referencias de la escena son estado de ejecucion: el .meta leido al
+    // escanear puede ir por detras
+    std::unordered_map<std::string, int> references;
+    for (const auto& meta : assets_) references[meta.guid] = meta.referenceCount;
+    // Ajustes editados mientras importaba: el batch se hizo con los de antes
+    std::unordered_map<std::string, AssetMeta> edited;
+    for (const auto& guid : editedDuringImport_) {
+        if (const AssetMeta* meta = findAssetByGUID(guid)) edited[guid] = *meta;
+    }
+    editedDuringImport_.clear();
+
     assets_.clear();
- guid_to_index_.clear();
+    guid_to_index_.clear();
     path_to_index_.clear();
+    size_t imported = 0;
+    for (size_t i = 0; i < batch->metas.size(); ++i) {
+        AssetMeta& meta = batch->metas[i];
+        auto ref = references.find(meta.guid);
+        if (ref != references.end()) meta.referenceCount = ref->second;
+        auto e = edited.find(meta.guid);
+        if (e != edited.end()) {
+            // Se conserva la edicion y se reescribe el .meta por si el worker lo
+            // piso; el refresh que dejo en cola la edicion reimporta con ella
+            copyImportSettings(meta, e->second);
+            AssetMeta::saveToFile(meta.sourcePath + ".meta", meta);
+            refreshQueued_ = true;
+        }
+        addAsset(meta);
+        imported += batch->imported[i];
+    }
+    LOG_INFO("AssetDatabase: Refresh complete. Found " + std::to_string(assets_.size()) + " assets ("
+        + std::to_string(imported) + " imported, " + std::to_string(assets_.size() - imported) + " up to date).");
+}
 
-    LOG_INFO("AssetDatabase: Scanning Assets folder...");
- scanAssetsFolder();
-    ensureMetaFiles();
-    LOG_INFO("AssetDatabase: Refresh complete. Found " + std::to_string(assets_.size()) + " assets.");
+void AssetDatabase::addAsset(const AssetMeta& meta) {
+    size_t index = assets_.size();
+    guid_to_index_[meta.guid] = index;
+    path_to_index_[meta.sourcePath] = index;
+    assets_.push_back(meta);
 }
 
 std::string AssetDatabase::determineAssetType(const std::string& filename) {
@@ -58,10 +212,11 @@ std::string AssetDatabase::determineAssetType(const std::string& filename) {
     return "Unknown";
 }
 
-void AssetDatabase::scanAssetsFolder() {
+std::vector<AssetMeta> AssetDatabase::scanAssetsFolder() const {
+    std::vector<AssetMeta> found;
  if (!fs::exists(assets_path_)) {
         LOG_WARN("Assets folder does not exist: " + assets_path_);
-     return;
+     return found;
     }
 
     for (const auto& entry : fs::recursive_directory_iterator(assets_path_)) {
@@ -71,12 +226,17 @@ void AssetDatabase::scanAssetsFolder() {
       // Skip .meta files
             if (filename.size() >= 5 && filename.substr(filename.size() - 5) == ".meta") continue;
 
-            loadAssetMetadata(entry.path());
+            found.push_back(loadAssetMetadata(entry.path()));
         }
     }
+    // El orden del directory_iterator no esta definido
+    std::sort(found.begin(), found.end(), [](const AssetMeta& a, const AssetMeta& b) {
+        return a.sourcePath < b.sourcePath;
+    });
+    return found;
 }
 
-void AssetDatabase::loadAssetMetadata(const fs::path& assetPath) {
+AssetMeta AssetDatabase::loadAssetMetadata(const fs::path& assetPath) const {
     std::string sourcePath = assetPath.string();
     std::string metaPath = sourcePath + ".meta";
 
@@ -90,6 +250,9 @@ void AssetDatabase::loadAssetMetadata(const fs::path& assetPath) {
         // RECONSTRUCT paths based on current environment (portability fix)
         meta.sourcePath = sourcePath;
         meta.libraryPath = (fs::path(library_path_) / meta.guid).string();
+        // Las referencias son del proceso (las lleva el ResourceManager); un valor
+        // viejo en el .meta bloquearia el borrado del asset para siempre
+        meta.referenceCount = 0;
     } else {
         // Create new metadata
         meta.guid = AssetMeta::generateGUID();
@@ -112,36 +275,76 @@ void AssetDatabase::loadAssetMetadata(const fs::path& assetPath) {
         }
     }
 
-    // Update timestamp
-    meta.sourceTimestamp = fs::last_write_time(assetPath).time_since_epoch().count();
+    return meta;
+}
 
-    // Add to database
-    size_t index = assets_.size();
-    guid_to_index_[meta.guid] = index;
-    path_to_index_[meta.sourcePath] = index;
-    assets_.push_back(meta);
+void AssetDatabase::refreshSourceHash(AssetMeta& meta) {
+    std::error_code ec;
+    const int64_t timestamp = fs::last_write_time(meta.sourcePath, ec).time_since_epoch().count();
+    if (ec) return;
+    const uint64_t size = fs::file_size(meta.sourcePath, ec);
+    if (ec) return;
+    if (meta.sourceHash != 0 && meta.sourceTimestamp == timestamp && meta.sourceSize == size) return;
+
+    uint64_t hash = 0;
+    if (!HashFile(meta.sourcePath, hash)) {
+        LOG_WARN("Could not hash asset: " + meta.sourcePath);
+        return;
+    }
+    meta.sourceTimestamp = timestamp;
+    meta.sourceSize = size;
+    meta.sourceHash = hash;
 }
 
-void AssetDatabase::ensureMetaFiles() {
-    for (auto& meta : assets_) {
-     std::string metaPath = meta.sourcePath + ".meta";
-        
-        // Save metadata file
-        if (!fs::exists(metaPath) || true) {  // Always update
-            AssetMeta::saveToFile(metaPath, meta);
-        }
+uint64_t AssetDatabase::importKey(AssetMeta& meta) {
+    refreshSourceHash(meta);
+    return cachedImportKey(meta);
+}
 
- // Copy to library if not present
-        if (!fs::exists(meta.libraryPath)) {
-   copyAssetToLibrary(meta);
-        }
+uint64_t AssetDatabase::cachedImportKey(const AssetMeta& meta) {
+    HashBuilder key;
+    key.add(meta.sourceHash).add(meta.assetType);
+    if (meta.assetType == "Model") {
+        key.add((uint64_t)ModelLoader::kProcessorVersion)
+           .add(meta.meshScale).add(meta.axisUp).add(meta.axisForward);
     }
+    else if (meta.assetType == "Texture") {
+        key.add((uint64_t)kTextureProcessorVersion)
+           .add(meta.texFlipX).add(meta.texFlipY)
+           .add(meta.texMinFilter).add(meta.texMagFilter).add(meta.texMipmaps);
+    }
+    return key.finish();
+}
+
+bool AssetDatabase::isLibraryCurrent(const AssetMeta& meta, uint64_t key) const {
+    if (meta.assetType == "Model") return ModelLoader::libraryKey(meta) == key;
+    return fs::exists(meta.libraryPath) && readKeyFile(keyFilePath(meta)) == key;
+}
+
+bool AssetDatabase::processAsset(AssetMeta& meta) {
+    const std::string metaPath = meta.sourcePath + ".meta";
+    const int64_t oldTimestamp = meta.sourceTimestamp;
+    const uint64_t oldSize = meta.sourceSize, oldHash = meta.sourceHash;
+    const uint64_t key = importKey(meta);
+
+    // El .meta solo se escribe si es nuevo o cambio el hash del fuente: los
+    // ajustes son los del escaneo, y el inspector puede haberlos cambiado despues
+    if (!fs::exists(metaPath) || meta.sourceTimestamp != oldTimestamp
+        || meta.sourceSize != oldSize || meta.sourceHash != oldHash)
+        AssetMeta::saveToFile(metaPath, meta);
+
+    // Solo se regenera el artefacto si su clave no coincide
+    return !isLibraryCurrent(meta, key) && copyAssetToLibrary(meta, key);
 }
 
-bool AssetDatabase::copyAssetToLibrary(const AssetMeta& meta) {
+bool AssetDatabase::copyAssetToLibrary(const AssetMeta& meta, uint64_t key) {
+    // Los modelos se importan a un blob binario que lleva la clave en la cabecera;
+    // el resto se copia tal cual con la clave en un .key al lado
+    if (meta.assetType == "Model") return ModelLoader::importToLibrary(meta, key);
     try {
  fs::create_directories(fs::path(meta.libraryPath).parent_path());
         fs::copy_file(meta.sourcePath, meta.libraryPath, fs::copy_options::overwrite_existing);
+        writeKeyFile(keyFilePath(meta), key);
         LOG_INFO("Copied asset to library: " + meta.libraryPath);
         return true;
     } catch (const std::exception& e) {
@@ -163,13 +366,22 @@ bool AssetDatabase::importAsset(const std::string& sourcePath) {
     }
 
     // Load and register the asset
-    loadAssetMetadata(fs::path(sourcePath));
-    ensureMetaFiles();
+    AssetMeta meta = loadAssetMetadata(fs::path(sourcePath));
+    processAsset(meta);
+    addAsset(meta);
+    // Un refresh asincrono en curso no lo habria visto
+    if (batch_) refreshQueued_ = true;
 
     LOG_INFO("Asset imported: " + sourcePath);
     return true;
 }
 
+void AssetDatabase::saveAssetSettings(const AssetMeta& meta) {
+    AssetMeta::saveToFile(meta.sourcePath + ".meta", meta);
+    if (batch_) editedDuringImport_.insert(meta.guid);
+    refreshAsync();
+}
+
 bool AssetDatabase::deleteAsset(const std::string& sourcePath) {
    AssetMeta* meta = findAssetBySourcePath(sourcePath);
     if (!meta) {
@@ -198,6 +410,7 @@ bool AssetDatabase::deleteAsset(const std::string& sourcePath) {
   if (fs::exists(meta->libraryPath)) {
     fs::remove(meta->libraryPath);
         }
+        fs::remove(keyFilePath(*meta));
 
         // Remove from database
     auto it = guid_to_index_.find(meta->guid);
@@ -208,6 +421,7 @@ bool AssetDatabase::deleteAsset(const std::string& sourcePath) {
             path_to_index_.erase(meta->sourcePath);
     }
 
+        if (batch_) refreshQueued_ = true;
         LOG_INFO("Asset deleted: " + sourcePath);
         return true;
     } catch (const std::exception& e) {
@@ -224,6 +438,17 @@ AssetMeta* AssetDatabase::findAssetBySourcePath(const std::string& sourcePath) {
     return nullptr;
 }
 
+AssetMeta* AssetDatabase::findAssetForFile(const std::string& path) {
+    if (AssetMeta* meta = findAssetBySourcePath(path)) return meta;
+    std::error_code ec;
+    const fs::path wanted = fs::weakly_canonical(fs::path(path), ec);
+    if (ec) return nullptr;
+    for (auto& meta : assets_) {
+        if (fs::weakly_canonical(fs::path(meta.sourcePath), ec) == wanted && !ec) return &meta;
+    }
+    return nullptr;
+}
+
 AssetMeta* AssetDatabase::findAssetByGUID(const std::string& guid) {
     auto it = guid_to_index_.find(guid);
     if (it != guid_to_index_.end()) {
@@ -236,7 +461,6 @@ void AssetDatabase::incrementReference(const std::string& guid) {
     AssetMeta* meta = findAssetByGUID(guid);
     if (meta) {
         meta->referenceCount++;
-   LOG_INFO("Incremented reference count for asset " + guid + " to " + std::to_string(meta->referenceCount));
     }
 }
 
@@ -244,7 +468,6 @@ void AssetDatabase::decrementReference(const std::string& guid) {
     AssetMeta* meta = findAssetByGUID(guid);
     if (meta && meta->referenceCount > 0) {
         meta->referenceCount--;
-        LOG_INFO("Decremented reference count for asset " + guid + " to " + std::to_string(meta->referenceCount));
     }
 }
 
@@ -3,6 +3,7 @@
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <filesystem>
 
 /**
@@ -18,15 +19,26 @@ public:
   void shutdown();
 
     // Asset discovery and refreshing
-    void refresh();  // Scan /Assets and regenerate /Library
+    void refresh();  // Scan /Assets and regenerate /Library (bloquea hasta terminar)
+    // Igual que refresh, pero la importacion corre en el JobSystem y el editor
+    // sigue pintando; assets_ no cambia hasta que pollImport integra el resultado
+    void refreshAsync();
+    void pollImport();  // Una vez por frame, en el hilo principal
+    bool isImporting() const { return batch_ != nullptr; }
+    void importProgress(size_t& done, size_t& total) const;
     
     // Asset importing
     bool importAsset(const std::string& sourcePath);
     bool deleteAsset(const std::string& sourcePath);
+    // Guarda el .meta de un asset cuyos ajustes se han editado y reimporta en
+    // segundo plano. Si hay un refresh en curso, sus ajustes no pisan la edicion
+    void saveAssetSettings(const AssetMeta& meta);
 
     // Asset querying
     AssetMeta* findAssetBySourcePath(const std::string& sourcePath);
     AssetMeta* findAssetByGUID(const std::string& guid);
+    // Como findAssetBySourcePath, pero acepta rutas equivalentes (relativas, otros separadores)
+    AssetMeta* findAssetForFile(const std::string& path);
     const std::vector<AssetMeta>& getAllAssets() const { return assets_; }
 
     // Reference counting
@@ -41,9 +53,30 @@ public:
     // Determine asset type from file extension
     static std::string determineAssetType(const std::string& filename);
 
+    // Clave de importacion: hash del contenido del fuente + ajustes del .meta que
+    // afectan al artefacto + version del procesador. Si coincide con la del
+    // artefacto de Library, no se reimporta (un touch o un .meta sin cambios
+    // relevantes no cuesta nada). Solo toca meta: se puede llamar desde un worker
+    // con una copia. Rehashea el fuente si cambiaron fecha o tamano
+    static uint64_t importKey(AssetMeta& meta);
+    // La misma clave con el hash que ya tiene meta, sin mirar el disco: para el
+    // hilo principal. Un fuente modificado se detecta en el siguiente refresh
+    static uint64_t cachedImportKey(const AssetMeta& meta);
+
+    // Subirla cuando cambie lo que se escribe en Library para texturas
+    static const uint32_t kTextureProcessorVersion = 1;
+
 private:
     AssetDatabase() = default;
 
+    // Un refresh en curso: los metas se procesan en paralelo, cada uno en su
+    // hueco, y se integran en orden de ruta (el resultado no depende de que
+    // hilo acabe antes)
+    struct ImportBatch;
+    std::shared_ptr<ImportBatch> batch_;
+    bool refreshQueued_ = false;
+    std::unordered_set<std::string> editedDuringImport_; // GUIDs editados con batch_ en marcha
+
     std::vector<AssetMeta> assets_;
 std::unordered_map<std::string, size_t> guid_to_index_;  // For quick lookup
     std::unordered_map<std::string, size_t> path_to_index_;  // For quick lookup
@@ -52,8 +85,18 @@ std::unordered_map<std::string, size_t> guid_to_index_;  // For quick lookup
     std::string library_path_;
 
     // Helper functions
-    void scanAssetsFolder();
-    void ensureMetaFiles();
-    bool copyAssetToLibrary(const AssetMeta& meta);
-    void loadAssetMetadata(const std::filesystem::path& assetPath);
+    std::shared_ptr<ImportBatch> startImport();
+    void runImport(ImportBatch& batch);
+    void waitImport(ImportBatch& batch);
+    void finishImport();
+    std::vector<AssetMeta> scanAssetsFolder() const;
+    // Hash, .meta y artefacto de Library de un asset. Solo toca el meta que
+    // recibe, asi que se puede llamar desde los workers
+    bool processAsset(AssetMeta& meta);
+    bool copyAssetToLibrary(const AssetMeta& meta, uint64_t key);
+    bool isLibraryCurrent(const AssetMeta& meta, uint64_t key) const;
+    AssetMeta loadAssetMetadata(const std::filesystem::path& assetPath) const;
+    void addAsset(const AssetMeta& meta);
+    // Rehashea el fuente solo si cambiaron fecha o tamano desde el ultimo hash
+    static void refreshSourceHash(AssetMeta& meta);
 };
@@ -39,6 +39,8 @@ bool AssetMeta::loadFromFile(const std::string& metaFilePath, AssetMeta& outMeta
  else if (key == "assetType") outMeta.assetType = value;
         else if (key == "referenceCount") outMeta.referenceCount = std::stoi(value);
         else if (key == "sourceTimestamp") outMeta.sourceTimestamp = std::stoll(value);
+        else if (key == "sourceSize") outMeta.sourceSize = std::stoull(value);
+        else if (key == "sourceHash") outMeta.sourceHash = std::stoull(value, nullptr, 16);
         else if (key == "texMinFilter") outMeta.texMinFilter = value;
         else if (key == "texMagFilter") outMeta.texMagFilter = value;
         else if (key == "texWrapS") outMeta.texWrapS = value;
@@ -66,6 +68,8 @@ bool AssetMeta::saveToFile(const std::string& metaFilePath, const AssetMeta& met
     file << "assetType: " << meta.assetType << "\n";
     file << "referenceCount: " << meta.referenceCount << "\n";
     file << "sourceTimestamp: " << meta.sourceTimestamp << "\n";
+    file << "sourceSize: " << meta.sourceSize << "\n";
+    file << "sourceHash: " << std::hex << meta.sourceHash << std::dec << "\n";
     file << "texMinFilter: " << meta.texMinFilter << "\n";
     file << "texMagFilter: " << meta.texMagFilter << "\n";
     file << "texWrapS: " << meta.texWrapS << "\n";
@@ -12,6 +12,8 @@ struct AssetMeta {
     std::string sourcePath;   // Path in /Assets/
     std::string libraryPath;    // Path in /Library/
     int64_t sourceTimestamp = 0; // Last modification time of source
+    uint64_t sourceSize = 0;     // Size of source when sourceHash was computed
+    uint64_t sourceHash = 0;     // XXH64 of the source content, valid for sourceTimestamp/sourceSize
     std::string assetType;      // "Model", "Texture", "Primitive", etc.
     int referenceCount = 0;     // How many GameObjects use this asset
     std::string texMinFilter = "Linear";
@@ -0,0 +1,92 @@
+#include "AsyncModelLoader.h"
+#include "JobSystem.h"
+#include "Logger.h"
+
+void ModelHandle::then(std::function<void(const ModelHandle&)> fn) {
+    if (isDone()) fn(*this);
+    else callbacks_.push_back(std::move(fn));
+}
+
+AsyncModelLoader& AsyncModelLoader::instance() {
+    static AsyncModelLoader inst;
+    return inst;
+}
+
+std::shared_ptr<ModelHandle> AsyncModelLoader::load(const std::string& path) {
+    auto handle = std::make_shared<ModelHandle>();
+    handle->path_ = path;
+    pending_.push_back(handle);
+
+    // El AssetDatabase solo se consulta desde el hilo principal; el hash del
+    // fuente para la clave de importacion ya lo hace el worker
+    ModelSource source = ModelLoader::resolveSource(path);
+    JobSystem::instance().submit([this, handle, source] {
+        handle->parseOk_ = ModelLoader::parseModel(source, handle->model_);
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            handle->parseDone_.store(true, std::memory_order_release);
+        }
+        cv_.notify_all();
+    });
+    return handle;
+}
+
+void AsyncModelLoader::update() {
+    size_t uploaded = 0;
+    std::vector<std::shared_ptr<ModelHandle>> finished;
+
+    for (size_t i = 0; i < pending_.size();) {
+        ModelHandle& h = *pending_[i];
+        if (h.state_ == ModelHandle::State::Parsing && h.parseDone_.load(std::memory_order_acquire)) {
+            if (h.parseOk_ && !h.model_.subMeshes.empty()) {
+                h.state_ = ModelHandle::State::Uploading;
+                h.meshes_.reserve(h.model_.subMeshes.size());
+            }
+            else {
+                h.state_ = ModelHandle::State::Failed;
+                LOG_ERROR("Failed to load model: " + h.path_);
+            }
+        }
+
+        if (h.state_ == ModelHandle::State::Uploading) {
+            auto& subs = h.model_.subMeshes;
+            while (h.nextUpload_ < subs.size()) {
+                const size_t bytes = subs[h.nextUpload_].uploadBytes();
+                if (uploaded > 0 && uploaded + bytes > uploadBudget_) break;
+                h.meshes_.push_back(ModelLoader::uploadSubMesh(subs[h.nextUpload_], h.textureCache_));
+                uploaded += bytes;
+                ++h.nextUpload_;
+            }
+            if (h.nextUpload_ == subs.size()) {
+                h.state_ = ModelHandle::State::Ready;
+                h.model_ = ParsedModel(); // El mapeo del blob queda en los meshes
+            }
+        }
+
+        if (h.isDone()) {
+            finished.push_back(std::move(pending_[i]));
+            pending_.erase(pending_.begin() + i);
+        }
+        else {
+            ++i;
+        }
+    }
+    lastUploadBytes_ = uploaded;
+
+    // Fuera del bucle: un callback puede pedir otra carga
+    for (auto& h : finished) {
+        auto callbacks = std::move(h->callbacks_);
+        for (auto& fn : callbacks) fn(*h);
+    }
+}
+
+void AsyncModelLoader::shutdown() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    cv_.wait(lock, [this] {
+        for (const auto& h : pending_)
+            if (!h->parseDone_.load(std::memory_order_acquire)) return false;
+        return true;
+    });
+    lock.unlock();
+    pending_.clear();
+}
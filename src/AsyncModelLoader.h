@@ -0,0 +1,67 @@
+#pragma once
+#include "ModelLoader.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Carga de un modelo en curso. Se consulta y se completa solo desde el hilo principal
+class ModelHandle {
+public:
+    enum class State { Parsing, Uploading, Ready, Failed };
+
+    State state() const { return state_; }
+    bool isDone() const { return state_ == State::Ready || state_ == State::Failed; }
+    const std::string& path() const { return path_; }
+    // Con Ready, un Mesh por sub-mesh del modelo (mismo orden que en el fichero)
+    const std::vector<std::shared_ptr<Mesh>>& meshes() const { return meshes_; }
+    // fn se llama en el hilo principal al terminar, con Ready o Failed.
+    // Si ya ha terminado se llama en el momento
+    void then(std::function<void(const ModelHandle&)> fn);
+
+private:
+    friend class AsyncModelLoader;
+    std::string path_;
+    State state_ = State::Parsing;
+    std::atomic<bool> parseDone_{ false }; // Lo pone el worker al acabar la fase de CPU
+    bool parseOk_ = false;
+    ParsedModel model_;
+    size_t nextUpload_ = 0;
+    ModelLoader::TextureCache textureCache_;
+    std::vector<std::shared_ptr<Mesh>> meshes_;
+    std::vector<std::function<void(const ModelHandle&)>> callbacks_;
+};
+
+// Carga de modelos sin congelar el editor: el blob o Assimp se leen en el
+// JobSystem y update() sube a GL, como mucho uploadBudget bytes por frame
+// (minimo un sub-mesh, para que uno enorme no se quede atascado). Los callers
+// crean el GameObject al momento y le ponen el mesh en el callback del handle.
+class AsyncModelLoader {
+public:
+    static AsyncModelLoader& instance();
+
+    std::shared_ptr<ModelHandle> load(const std::string& path);
+    // Una vez por frame, con el contexto GL activo
+    void update();
+    // Espera a los workers y descarta lo pendiente; antes de destruir el contexto
+    void shutdown();
+
+    void setUploadBudget(size_t bytes) { uploadBudget_ = bytes; }
+    size_t uploadBudget() const { return uploadBudget_; }
+    size_t pendingCount() const { return pending_.size(); }
+    size_t lastUploadBytes() const { return lastUploadBytes_; }
+
+private:
+    AsyncModelLoader() = default;
+    AsyncModelLoader(const AsyncModelLoader&) = delete;
+    AsyncModelLoader& operator=(const AsyncModelLoader&) = delete;
+
+    std::vector<std::shared_ptr<ModelHandle>> pending_; // En orden de peticion
+    size_t uploadBudget_ = 8 * 1024 * 1024;
+    size_t lastUploadBytes_ = 0;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+};
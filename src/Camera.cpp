@@ -52,7 +52,7 @@ void Camera::onMouseWheel(int direction) {
     // Zoom hacia adelante/atrás (como Unity)
     vec3 f = glm::normalize(transform.fwd());
     double delta = (double)direction * zoomSpeed;
-    transform.pos() += f * delta;
+    transform.setPosition(transform.pos() + f * delta);
 }
 
 void Camera::onKeyDown(int scancode) {
@@ -91,7 +91,7 @@ void Camera::focusOn(const vec3& targetCenter, double radius) {
 
     vec3 f = glm::normalize(transform.fwd());
     vec3 newPos = _orbitTarget - f * _orbitDistance;
-    transform.pos() = newPos;
+    transform.setPosition(newPos);
 }
 
 void Camera::_applyYawPitchToBasis() {
@@ -136,6 +136,6 @@ void Camera::_moveFPS(double dt) {
 
     if (glm::length(move) > 0.0001) {
         move = glm::normalize(move) * speed;
-        transform.pos() += move;
+        transform.setPosition(transform.pos() + move);
     }
 }
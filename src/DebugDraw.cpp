@@ -0,0 +1,311 @@
+#include "DebugDraw.h"
+#include "Renderer.h"
+#include "Logger.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+static const char* kLineVertexShader = R"(#version 330 core
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec4 aColor;
+uniform mat4 uViewProj;
+out vec4 vColor;
+void main() {
+    vColor = aColor;
+    gl_Position = uViewProj * vec4(aPosition, 1.0);
+}
+)";
+
+static const char* kLineFragmentShader = R"(#version 330 core
+in vec4 vColor;
+out vec4 fragColor;
+void main() {
+    fragColor = vColor;
+}
+)";
+
+static GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+    GLint ok = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024] = { 0 };
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        LOG_ERROR(std::string("Debug line shader error: ") + log);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+DebugDraw& DebugDraw::instance() {
+    static DebugDraw g;
+    return g;
+}
+
+bool DebugDraw::init() {
+    shader_ = Renderer::instance().isShader();
+    if (!shader_) return true;
+    if (!buildProgram()) {
+        shader_ = false; // Sigue funcionando con arrays de cliente
+        return false;
+    }
+    glGenVertexArrays(1, &vao_);
+    return true;
+}
+
+bool DebugDraw::buildProgram() {
+    GLuint vs = compileShader(GL_VERTEX_SHADER, kLineVertexShader);
+    GLuint fs = compileShader(GL_FRAGMENT_SHADER, kLineFragmentShader);
+    if (!vs || !fs) {
+        if (vs) glDeleteShader(vs);
+        if (fs) glDeleteShader(fs);
+        return false;
+    }
+    program_ = glCreateProgram();
+    glAttachShader(program_, vs);
+    glAttachShader(program_, fs);
+    glLinkProgram(program_);
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+    GLint ok = GL_FALSE;
+    glGetProgramiv(program_, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        glDeleteProgram(program_);
+        program_ = 0;
+        return false;
+    }
+    uViewProj_ = glGetUniformLocation(program_, "uViewProj");
+    return true;
+}
+
+void DebugDraw::shutdown() {
+    if (vao_) { glDeleteVertexArrays(1, &vao_); vao_ = 0; }
+    if (gridVAO_) { glDeleteVertexArrays(1, &gridVAO_); gridVAO_ = 0; }
+    if (gridVBO_) { glDeleteBuffers(1, &gridVBO_); gridVBO_ = 0; }
+    if (program_) { glDeleteProgram(program_); program_ = 0; }
+    for (Layer& l : layers_) l.vertices.clear();
+    buffers_.clear();
+    gridVertices_ = 0;
+    gridSize_ = 0;
+    shader_ = false;
+}
+
+DebugDraw::Layer& DebugDraw::layerFor(float width, bool depthTest) {
+    return layers_[(width > 1.5f ? 1 : 0) + (depthTest ? 0 : 2)];
+}
+
+DebugDraw::LineVertex DebugDraw::makeVertex(const vec3& p, const glm::u8vec3& color) {
+    LineVertex v;
+    v.position[0] = (float)p.x;
+    v.position[1] = (float)p.y;
+    v.position[2] = (float)p.z;
+    v.color[0] = color.r;
+    v.color[1] = color.g;
+    v.color[2] = color.b;
+    v.color[3] = 255;
+    return v;
+}
+
+void DebugDraw::line(const vec3& a, const vec3& b, const glm::u8vec3& color, float width, bool depthTest) {
+    auto& out = layerFor(width, depthTest).vertices;
+    out.push_back(makeVertex(a, color));
+    out.push_back(makeVertex(b, color));
+}
+
+void DebugDraw::box(const AABB& box, const glm::u8vec3& color, float width, bool depthTest) {
+    const vec3& mn = box.min;
+    const vec3& mx = box.max;
+    const vec3 c[8] = {
+        { mn.x, mn.y, mn.z }, { mx.x, mn.y, mn.z }, { mx.x, mn.y, mx.z }, { mn.x, mn.y, mx.z },
+        { mn.x, mx.y, mn.z }, { mx.x, mx.y, mn.z }, { mx.x, mx.y, mx.z }, { mn.x, mx.y, mx.z }
+    };
+    static const int edges[12][2] = {
+        {0,1},{1,2},{2,3},{3,0}, {4,5},{5,6},{6,7},{7,4}, {0,4},{1,5},{2,6},{3,7}
+    };
+    auto& out = layerFor(width, depthTest).vertices;
+    for (const auto& e : edges) {
+        out.push_back(makeVertex(c[e[0]], color));
+        out.push_back(makeVertex(c[e[1]], color));
+    }
+}
+
+void DebugDraw::frustum(const vec3 corners[8], const glm::u8vec3& color, float width, bool depthTest) {
+    // Plano near, plano far y las cuatro aristas que los unen
+    static const int edges[12][2] = {
+        {0,1},{1,3},{3,2},{2,0}, {4,5},{5,7},{7,6},{6,4}, {0,4},{1,5},{2,6},{3,7}
+    };
+    auto& out = layerFor(width, depthTest).vertices;
+    for (const auto& e : edges) {
+        out.push_back(makeVertex(corners[e[0]], color));
+        out.push_back(makeVertex(corners[e[1]], color));
+    }
+}
+
+void DebugDraw::lineBuffer(GLuint vbo, GLint first, GLsizei count, const mat4& world) {
+    if (!vbo || count <= 0) return;
+    buffers_.push_back({ vbo, first, count, world });
+}
+
+void DebugDraw::bindVertexLayout(GLuint buffer, size_t offset) {
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(LineVertex),
+        reinterpret_cast<const void*>(offset + offsetof(LineVertex, position)));
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(LineVertex),
+        reinterpret_cast<const void*>(offset + offsetof(LineVertex, color)));
+}
+
+void DebugDraw::beginDraw(const mat4& viewProj) {
+    glDisable(GL_LIGHTING);
+    if (shader_) {
+        glUseProgram(program_);
+        glm::mat4 vp(viewProj);
+        glUniformMatrix4fv(uViewProj_, 1, GL_FALSE, glm::value_ptr(vp));
+    }
+    else {
+        glBindVertexArray(0);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+    }
+}
+
+void DebugDraw::endDraw() {
+    if (shader_) {
+        glBindVertexArray(0);
+        glUseProgram(0);
+    }
+    else {
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        // Tras un draw con array de color el color actual queda indefinido
+        glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glLineWidth(1.0f);
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_LIGHTING);
+}
+
+void DebugDraw::drawGrid(int size, double step, const glm::u8vec3& color, const mat4& viewProj) {
+    if (size <= 0 || step <= 0.0) return;
+    if (!gridVBO_ || size != gridSize_ || step != gridStep_ || color != gridColor_) {
+        std::vector<LineVertex> verts;
+        for (double i = -size; i <= size; i += step) {
+            verts.push_back(makeVertex(vec3(i, 0, -size), color));
+            verts.push_back(makeVertex(vec3(i, 0, size), color));
+            verts.push_back(makeVertex(vec3(-size, 0, i), color));
+            verts.push_back(makeVertex(vec3(size, 0, i), color));
+        }
+        if (!gridVBO_) glGenBuffers(1, &gridVBO_);
+        glBindBuffer(GL_ARRAY_BUFFER, gridVBO_);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(verts.size() * sizeof(LineVertex)), verts.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        gridVertices_ = (GLsizei)verts.size();
+        gridSize_ = size;
+        gridStep_ = step;
+        gridColor_ = color;
+
+        if (shader_) {
+            if (!gridVAO_) glGenVertexArrays(1, &gridVAO_);
+            glBindVertexArray(gridVAO_);
+            bindVertexLayout(gridVBO_, 0);
+            glBindVertexArray(0);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+    }
+
+    beginDraw(viewProj);
+    if (shader_) {
+        glBindVertexArray(gridVAO_);
+    }
+    else {
+        glBindBuffer(GL_ARRAY_BUFFER, gridVBO_);
+        glVertexPointer(3, GL_FLOAT, sizeof(LineVertex), reinterpret_cast<const void*>(offsetof(LineVertex, position)));
+        glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(LineVertex), reinterpret_cast<const void*>(offsetof(LineVertex, color)));
+    }
+    glDrawArrays(GL_LINES, 0, gridVertices_);
+    ++frameDraws_;
+    endDraw();
+}
+
+void DebugDraw::flush(const mat4& viewProj) {
+    size_t total = 0;
+    for (const Layer& l : layers_) total += l.vertices.size();
+    if (total == 0 && buffers_.empty()) return;
+    frameLines_ += total / 2;
+
+    // Una sola subida con todas las capas seguidas
+    size_t firsts[kLayerCount] = {};
+    if (shader_ && total > 0) {
+        RingBuffer::Slice slice = Renderer::instance().ring().allocate(total * sizeof(LineVertex), sizeof(LineVertex));
+        if (!slice.data) {
+            for (Layer& l : layers_) l.vertices.clear();
+            return;
+        }
+        uint8_t* dst = static_cast<uint8_t*>(slice.data);
+        size_t first = 0;
+        for (int i = 0; i < kLayerCount; ++i) {
+            const auto& v = layers_[i].vertices;
+            firsts[i] = first;
+            if (!v.empty()) std::memcpy(dst + first * sizeof(LineVertex), v.data(), v.size() * sizeof(LineVertex));
+            first += v.size();
+        }
+        Renderer::instance().ring().commit(slice);
+        glBindVertexArray(vao_);
+        bindVertexLayout(slice.buffer, (size_t)slice.offset);
+    }
+
+    beginDraw(viewProj);
+    if (shader_) glBindVertexArray(vao_);
+    for (int i = 0; i < kLayerCount; ++i) {
+        Layer& l = layers_[i];
+        if (l.vertices.empty()) continue;
+        glLineWidth(l.width);
+        if (l.depthTest) glEnable(GL_DEPTH_TEST);
+        else glDisable(GL_DEPTH_TEST);
+        if (shader_) {
+            glDrawArrays(GL_LINES, (GLint)firsts[i], (GLsizei)l.vertices.size());
+        }
+        else {
+            glVertexPointer(3, GL_FLOAT, sizeof(LineVertex), &l.vertices[0].position);
+            glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(LineVertex), &l.vertices[0].color);
+            glDrawArrays(GL_LINES, 0, (GLsizei)l.vertices.size());
+        }
+        ++frameDraws_;
+        l.vertices.clear();
+    }
+    drawBuffers(viewProj);
+    endDraw();
+}
+
+void DebugDraw::drawBuffers(const mat4& viewProj) {
+    if (buffers_.empty()) return;
+    glLineWidth(1.0f);
+    glEnable(GL_DEPTH_TEST);
+    if (shader_) glBindVertexArray(vao_);
+    else glMatrixMode(GL_MODELVIEW);
+    for (const BufferDraw& b : buffers_) {
+        if (shader_) {
+            glm::mat4 mvp(viewProj * b.world);
+            glUniformMatrix4fv(uViewProj_, 1, GL_FALSE, glm::value_ptr(mvp));
+            bindVertexLayout(b.vbo, 0);
+        }
+        else {
+            glPushMatrix();
+            glMultMatrixd(glm::value_ptr(b.world));
+            glBindBuffer(GL_ARRAY_BUFFER, b.vbo);
+            glVertexPointer(3, GL_FLOAT, sizeof(LineVertex), reinterpret_cast<const void*>(offsetof(LineVertex, position)));
+            glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(LineVertex), reinterpret_cast<const void*>(offsetof(LineVertex, color)));
+        }
+        glDrawArrays(GL_LINES, b.first, b.count);
+        if (!shader_) glPopMatrix();
+        frameLines_ += (size_t)b.count / 2;
+        ++frameDraws_;
+    }
+    buffers_.clear();
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "types.h"
+#include "AABB.h"
+#include <vector>
+#include <cstdint>
+#include <GL/glew.h>
+
+// Lineas de debug (AABBs, nodos del Octree, frustums, normales) acumuladas en
+// CPU durante la frame y enviadas con una sola subida y un draw por estado
+// (grosor y depth test). La rejilla del suelo va en un VBO estatico.
+// Con el renderer GLSL la subida va al ring de datos dinamicos; en legacy se
+// dibuja desde arrays en memoria de cliente.
+class DebugDraw {
+public:
+    static DebugDraw& instance();
+
+    // Formato de los buffers de lineas (16 bytes)
+    struct LineVertex {
+        float position[3];
+        uint8_t color[4];
+    };
+    static LineVertex makeVertex(const vec3& p, const glm::u8vec3& color);
+
+    // Llamar despues de Renderer::init, con el backend ya decidido
+    bool init();
+    void shutdown();
+
+    void line(const vec3& a, const vec3& b, const glm::u8vec3& color, float width = 1.0f, bool depthTest = true);
+    void box(const AABB& box, const glm::u8vec3& color, float width = 1.0f, bool depthTest = true);
+    // Esquinas en el orden de Frustum::getCorners
+    void frustum(const vec3 corners[8], const glm::u8vec3& color, float width = 2.0f, bool depthTest = false);
+    // VBO de LineVertex ya subido (p.ej. las normales cacheadas de un Mesh), en
+    // espacio local. Se dibuja en flush con su matriz de mundo: un draw por llamada
+    void lineBuffer(GLuint vbo, GLint first, GLsizei count, const mat4& world);
+
+    // Rejilla en el plano XZ, de -size a size; el VBO se rehace si cambian los parametros
+    void drawGrid(int size, double step, const glm::u8vec3& color, const mat4& viewProj);
+    // Dibuja y vacia lo acumulado. En legacy las matrices ya estan en la pila de GL.
+    void flush(const mat4& viewProj);
+
+    // Contadores de la frame, para el panel de Config
+    void beginFrame() { frameLines_ = 0; frameDraws_ = 0; }
+    size_t frameLineCount() const { return frameLines_; }
+    int frameDrawCalls() const { return frameDraws_; }
+
+private:
+    DebugDraw() = default;
+    DebugDraw(const DebugDraw&) = delete;
+    DebugDraw& operator=(const DebugDraw&) = delete;
+
+    // Un array por combinacion de estado: grosor 1/2, con o sin depth test
+    static constexpr int kLayerCount = 4;
+    struct Layer {
+        float width;
+        bool depthTest;
+        std::vector<LineVertex> vertices;
+    };
+
+    struct BufferDraw {
+        GLuint vbo;
+        GLint first;
+        GLsizei count;
+        mat4 world;
+    };
+
+    Layer& layerFor(float width, bool depthTest);
+    bool buildProgram();
+    void bindVertexLayout(GLuint buffer, size_t offset);
+    void beginDraw(const mat4& viewProj);
+    void endDraw();
+    void drawBuffers(const mat4& viewProj);
+
+    Layer layers_[kLayerCount] = {
+        { 1.0f, true, {} }, { 2.0f, true, {} }, { 1.0f, false, {} }, { 2.0f, false, {} }
+    };
+    std::vector<BufferDraw> buffers_;
+    bool shader_ = false;
+    GLuint program_ = 0;
+    GLint uViewProj_ = -1;
+    GLuint vao_ = 0;       // Lineas dinamicas, apuntando al slice del ring
+    GLuint gridVAO_ = 0;
+    GLuint gridVBO_ = 0;
+    GLsizei gridVertices_ = 0;
+    int gridSize_ = 0;
+    double gridStep_ = 0.0;
+    glm::u8vec3 gridColor_ = glm::u8vec3(0);
+    size_t frameLines_ = 0;
+    int frameDraws_ = 0;
+};
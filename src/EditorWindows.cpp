@@ -8,9 +8,22 @@
 #include <vector>
 #include <algorithm>
 #include <cstdlib>
+#include <cstdio>
 #include "ModelLoader.h"
 #include "Camera.h"
 #include "AssetDatabase.h"
+#include "Octree.h"
+#include "FrustumBatch.h"
+#include "TransformHierarchy.h"
+#include "JobSystem.h"
+#include "Renderer.h"
+#include "StaticBatcher.h"
+#include "MeshArena.h"
+#include "DebugDraw.h"
+#include "GpuPicker.h"
+#include "OutlinePass.h"
+#include "AsyncModelLoader.h"
+#include "ResourceManager.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -43,6 +56,7 @@ void EditorWindows::init(SDL_Window* window, SDL_GLContext gl) {
 
 void EditorWindows::shutdown() {
     if (checker_tex_) { glDeleteTextures(1, &checker_tex_); checker_tex_ = 0; }
+    prev_tex_.clear();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplSDL3_Shutdown();
     ImGui::DestroyContext();
@@ -88,6 +102,7 @@ void EditorWindows::render(bool* isPlaying, bool* isPaused, bool* step) {
     if (show_console_)   drawConsole();
     if (show_config_)    drawConfig();
     if (show_hierarchy_) drawHierarchy();
+    prunePrevTextures();
     if (show_inspector_) drawInspector();
     if (show_assets_)    drawAssets();
     if (show_about_) {
@@ -269,9 +284,83 @@ void EditorWindows::drawConfig() {
     ImGui::Text("OpenGL : %s", (const char*)glGetString(GL_VERSION));
     ImGui::Text("GPU    : %s", (const char*)glGetString(GL_RENDERER));
     ImGui::Text("Vendor : %s", (const char*)glGetString(GL_VENDOR));
+    ImGui::Text("Render : %s", Renderer::instance().backendName());
+    {
+        const Renderer::Stats& rs = Renderer::instance().stats();
+        ImGui::Text("Draw calls : %d (%d objects)", rs.drawCalls, rs.submitted);
+        ImGui::Text("Instancing : %d objects in %d batches", rs.instancedObjects, rs.instancedBatches);
+        ImGui::Text("Debug lines: %d in %d draws", (int)DebugDraw::instance().frameLineCount(),
+            DebugDraw::instance().frameDrawCalls());
+        if (Renderer::instance().isShader()) {
+            const RingBuffer& ring = Renderer::instance().ring();
+            ImGui::Text("Dynamic    : %.1f / %.0f KB per frame (%s, %d fence waits)",
+                ring.usedThisFrame() / 1024.0, ring.frameBytes() / 1024.0,
+                ring.isPersistent() ? "persistent" : "orphaned", ring.lastFrameWaits());
+        }
+        if (Renderer::instance().indirectSupported()) {
+            bool indirect = Renderer::instance().isIndirectEnabled();
+            if (ImGui::Checkbox("Multi-draw indirect", &indirect))
+                Renderer::instance().setIndirectEnabled(indirect);
+            if (indirect) {
+                const MeshArena& arena = MeshArena::instance();
+                ImGui::Text("Indirect   : %d commands in %d calls, arena %d meshes %.1f / %.1f KB",
+                    rs.indirectCommands, rs.indirectDraws, (int)arena.meshCount(),
+                    arena.usedBytes() / 1024.0, arena.capacityBytes() / 1024.0);
+            }
+        }
+        if (GpuPicker::instance().isAvailable()) {
+            bool gpuPick = GpuPicker::instance().isEnabled();
+            if (ImGui::Checkbox("GPU picking", &gpuPick))
+                GpuPicker::instance().setEnabled(gpuPick);
+            if (gpuPick) {
+                ImGui::Text("Picking    : %d candidates, result after %d frames",
+                    GpuPicker::instance().lastCandidateCount(), GpuPicker::instance().lastLatencyFrames());
+            }
+        }
+        if (OutlinePass::instance().isAvailable()) {
+            bool outline = OutlinePass::instance().isEnabled();
+            if (ImGui::Checkbox("Stencil selection outline", &outline))
+                OutlinePass::instance().setEnabled(outline);
+        }
+        ImGui::Text("Binds      : %d program, %d texture, %d VAO (%d skipped)",
+            rs.programBinds, rs.textureBinds, rs.vaoBinds, rs.bindsSkipped);
+        if (static_batcher_ && static_batcher_->objectCount() > 0) {
+            ImGui::Text("Static     : %d objects in %d batches (%.1f KB)",
+                (int)static_batcher_->objectCount(), (int)static_batcher_->batches().size(),
+                static_batcher_->gpuBytes() / 1024.0);
+            ImGui::Text("             %d visible drawn with %d draw calls", rs.staticObjects, rs.staticDraws);
+        }
+    }
     ImGui::Separator();
     ImGui::Text("SDL CPU cores : %d", SDL_GetNumLogicalCPUCores());
     ImGui::Text("SDL SystemRAM : %d MB", SDL_GetSystemRAM());
+    ImGui::Text("Job workers   : %d", (int)JobSystem::instance().workerCount());
+    {
+        AsyncModelLoader& loader = AsyncModelLoader::instance();
+        int budgetKB = (int)(loader.uploadBudget() / 1024);
+        if (ImGui::DragInt("Upload budget (KB/frame)", &budgetKB, 64.0f, 64, 256 * 1024))
+            loader.setUploadBudget((size_t)budgetKB * 1024);
+        ImGui::Text("Model loads   : %d pending, %.1f KB uploaded last frame",
+            (int)loader.pendingCount(), loader.lastUploadBytes() / 1024.0);
+        ImGui::Text("Resources     : %d models, %d textures cached",
+            (int)ResourceManager::instance().modelCount(), (int)ResourceManager::instance().textureCount());
+    }
+    {
+        MeshMemoryStats mem = Mesh::memoryStats();
+        const double kb = 1.0 / 1024.0;
+        ImGui::Text("Mesh GPU mem  : %.1f KB (double layout: %.1f KB)", mem.gpuBytes * kb, mem.doubleLayoutBytes * kb);
+        if (mem.doubleLayoutBytes > 0) {
+            ImGui::Text("                -%.0f%%, %d packed / %d float meshes",
+                100.0 * (1.0 - (double)mem.gpuBytes / (double)mem.doubleLayoutBytes),
+                (int)mem.packedMeshes, (int)mem.floatMeshes);
+        }
+        ImGui::Text("Mesh CPU mem  : %.1f KB", mem.cpuBytes * kb);
+    }
+    if (transforms_) {
+        ImGui::Text("Transforms    : %d objects, %d levels, %d updated, %.3f ms",
+            (int)transforms_->size(), (int)transforms_->levelCount(),
+            (int)transforms_->lastUpdatedCount(), transforms_->lastUpdateMs());
+    }
     ImGui::Separator();
     ImGui::TextColored(ImVec4(0.4f, 0.8f, 1.0f, 1.0f), "Debug Visualization");
     ImGui::Separator();
@@ -287,6 +376,13 @@ void EditorWindows::drawConfig() {
     if (ImGui::IsItemHovered()) {
         ImGui::SetTooltip("Skip rendering objects outside camera view");
     }
+    if (ImGui::Checkbox("Use Octree", &use_octree_)) {
+        LOG_INFO(use_octree_ ? "Octree culling enabled" : "Octree culling disabled (brute force)");
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Off: test every object's AABB against the frustum in one SIMD batch");
+    }
+    ImGui::Text("Culling kernel : %s", FrustumBatch::kernelName());
     if (ImGui::Checkbox("Show Frustum", &show_frustum_)) {
         LOG_INFO(show_frustum_ ? "Frustum visualization enabled" : "Frustum visualization disabled");
     }
@@ -530,10 +626,14 @@ void EditorWindows::drawInspector() {
     if (selected_ && *selected_) {
         auto go = *selected_;
         ImGui::Text("Name: %s", go->name.c_str());
+        ImGui::Checkbox("Static", &go->isStatic);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Merged into a static batch with the other static objects that share its texture");
         ImGui::Separator();
         auto& T = go->transform;
+        const mat4 prevLocal = T.mat();
         if (ImGui::CollapsingHeader("Transform", ImGuiTreeNodeFlags_DefaultOpen)) {
-            auto pos = T.pos();
+            const vec3 pos = T.pos();
             float p[3] = { (float)pos.x, (float)pos.y, (float)pos.z };
             if (ImGui::DragFloat3("Position", p, 0.1f)) T.setPosition({ p[0], p[1], p[2] });
             ImGui::SameLine(); if (ImGui::Button("Reset##pos")) T.setPosition({ 0,0,0 });
@@ -552,6 +652,7 @@ void EditorWindows::drawInspector() {
             ImGui::SameLine(); if (ImGui::Button("Reset##scale")) T.resetScale();
             auto L = T.left(), U = T.up(), F = T.fwd();
         }
+        if (T.mat() != prevLocal) refreshInOctree(go.get());
 
         if (ImGui::CollapsingHeader("Mesh", ImGuiTreeNodeFlags_DefaultOpen)) {
             // Drop Target for Mesh
@@ -562,18 +663,27 @@ void EditorWindows::drawInspector() {
                     // Check extension
                     std::string ext = path.substr(path.find_last_of("."));
                     if (ext == ".fbx" || ext == ".obj" || ext == ".gltf" || ext == ".glb") {
-                         auto meshes = ModelLoader::loadModel(path);
-                         if (!meshes.empty()) {
-                             go->setMesh(meshes[0]);
-                             LOG_INFO("Dropped Mesh: " + path);
-                         } else {
-                             LOG_ERROR("Failed to load dropped mesh: " + path);
-                         }
+                         // Se carga en segundo plano; el objeto conserva su mesh hasta entonces
+                         go->meshLoading = true;
+                         std::weak_ptr<GameObject> weak = go;
+                         ResourceManager::instance().loadModel(path)->then([this, weak, path](const ModelHandle& h) {
+                             auto obj = weak.lock();
+                             if (!obj) return;
+                             obj->meshLoading = false;
+                             if (!h.meshes().empty()) {
+                                 obj->setMesh(ResourceManager::instance().acquireMesh(h, 0));
+                                 refreshInOctree(obj.get());
+                                 LOG_INFO("Dropped Mesh: " + path);
+                             } else {
+                                 LOG_ERROR("Failed to load dropped mesh: " + path);
+                             }
+                         });
                     }
                 }
                 ImGui::EndDragDropTarget();
             }
 
+            if (go->meshLoading) ImGui::TextColored(ImVec4(1, 0.8f, 0, 1), "Loading...");
             if (go->mesh) {
                 ImGui::Text("Vertices: %zu", go->mesh->getVertexCount());
                 ImGui::Text("Triangles: %zu", go->mesh->getTriangleCount());
@@ -598,7 +708,7 @@ void EditorWindows::drawInspector() {
             ImGui::BeginDisabled(texID == checker_tex_);
             if (ImGui::Button("Apply Checkerboard")) {
                 if (prev_tex_.find(go.get()) == prev_tex_.end())
-                    prev_tex_[go.get()] = texID;
+                    prev_tex_[go.get()] = { go->textureOverride(), go->textureRef(), go };
                 go->setTexture(checker_tex_);
                 LOG_INFO("Applied checkerboard texture to " + go->name);
             }
@@ -607,7 +717,9 @@ void EditorWindows::drawInspector() {
             bool canRestore = prev_tex_.find(go.get()) != prev_tex_.end();
             ImGui::BeginDisabled(!canRestore);
             if (ImGui::Button("Restore Texture")) {
-                go->setTexture(prev_tex_[go.get()]);
+                const PrevTexture& prev = prev_tex_[go.get()];
+                if (prev.ref) go->setTexture(prev.ref);
+                else go->setTexture(prev.id);
                 prev_tex_.erase(go.get());
                 LOG_INFO("Restored original texture for " + go->name);
             }
@@ -629,10 +741,10 @@ void EditorWindows::drawInspector() {
                     // Check extension
                     std::string ext = path.substr(path.find_last_of("."));
                     if (ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".dds" || ext == ".bmp") {
-                         GLuint newTex = ModelLoader::loadTexture(path);
+                         auto newTex = ResourceManager::instance().acquireTexture(path);
                          if (newTex) {
                              if (prev_tex_.find(go.get()) == prev_tex_.end())
-                                prev_tex_[go.get()] = go->getTextureID(); // Save old for restore
+                                prev_tex_[go.get()] = { go->textureOverride(), go->textureRef(), go }; // Save old for restore
                              go->setTexture(newTex);
                              LOG_INFO("Dropped Texture: " + path);
                          } else {
@@ -691,14 +803,19 @@ void EditorWindows::loadPrimitiveFromAssets(const std::string& name) {
     if (!scene_)return;
     std::string assets = getAssetsPath();
     fs::path p = fs::absolute(fs::path(assets) / "Primitives" / name);
-    auto meshes = ModelLoader::loadModel(p.string());
-    if (meshes.empty()) { LOG_ERROR("Failed to load primitive: " + p.string()); return; }
-    for (size_t i = 0; i < meshes.size(); ++i) {
-        auto go = std::make_shared<GameObject>(name + "_" + std::to_string(i));
-        go->setMesh(meshes[i]);
-        scene_->push_back(go);
-    }
-    LOG_INFO("Loaded primitive: " + p.string());
+    const std::string path = p.string();
+    // Las primitivas se piden muchas veces: la primera carga la comparten todas
+    ResourceManager::instance().loadModel(path)->then([this, name, path](const ModelHandle& h) {
+        if (!scene_) return;
+        if (h.meshes().empty()) { LOG_ERROR("Failed to load primitive: " + path); return; }
+        for (size_t i = 0; i < h.meshes().size(); ++i) {
+            auto go = std::make_shared<GameObject>(name + "_" + std::to_string(i));
+            go->setMesh(ResourceManager::instance().acquireMesh(h, i));
+            scene_->push_back(go);
+            if (octree_) octree_->insert(go);
+        }
+        LOG_INFO("Loaded primitive: " + path);
+    });
 }
 
 
@@ -713,6 +830,14 @@ void EditorWindows::setSelection(const std::shared_ptr<GameObject>& go) {
     if (*selected_) (*selected_)->isSelected = true;
 }
 
+void EditorWindows::refreshInOctree(GameObject* go) {
+    if (!octree_ || !go) return;
+    // Moving a node moves its whole subtree in world space
+    if (octree_->contains(go)) octree_->update(go);
+    else if (go->mesh) octree_->insert(findShared(go));
+    for (auto* c : go->children) refreshInOctree(c);
+}
+
 void EditorWindows::collectPostorder(GameObject* root, std::vector<GameObject*>& out) {
     if (!root) return;
     for (auto* c : root->children) collectPostorder(c, out);
@@ -731,6 +856,16 @@ void EditorWindows::removeFromScene(GameObject* raw) {
     for (auto it = v.begin(); it != v.end(); ++it) {
         if (it->get() == raw) { v.erase(it); break; }
     }
+    prev_tex_.erase(raw);
+}
+
+void EditorWindows::prunePrevTextures() {
+    for (auto it = prev_tex_.begin(); it != prev_tex_.end();) {
+        auto owner = it->second.owner.lock();
+        const bool inScene = owner && scene_ && std::find(scene_->begin(), scene_->end(), owner) != scene_->end();
+        if (inScene) ++it;
+        else it = prev_tex_.erase(it);
+    }
 }
 
 void EditorWindows::deleteSelectedRecursive() {
@@ -746,6 +881,7 @@ void EditorWindows::deleteSelectedRecursive() {
     }
     for (auto* n : post) {
         openNodes_.erase(n);
+        if (octree_) octree_->remove(n);
         removeFromScene(n);
     }
     pendingDelete_ = nullptr;
@@ -766,6 +902,7 @@ void EditorWindows::reparent(GameObject* dragged, GameObject* target) {
     if (preserve_world_) {
         setLocalFromWorld(dragged, M_old, target);
     }
+    refreshInOctree(dragged);
 }
 
 void EditorWindows::reorderSibling(GameObject* node, GameObject* parent, int newIndex) {
@@ -845,8 +982,8 @@ void EditorWindows::drawAssets() {
     // Toolbar
     if (ImGui::Button("Refresh##assets")) {
  if (asset_database_) {
-    asset_database_->refresh();
-            LOG_INFO("Assets refreshed from disk");
+    asset_database_->refreshAsync();
+            LOG_INFO("Refreshing assets from disk");
   }
     }
     ImGui::SameLine();
@@ -861,6 +998,15 @@ void EditorWindows::drawAssets() {
     ImGui::SameLine();
     ImGui::Checkbox("Show References##assetdb", &show_asset_refs_);
 
+    // Progreso del refresh en segundo plano
+    if (asset_database_ && asset_database_->isImporting()) {
+        size_t done = 0, total = 0;
+        asset_database_->importProgress(done, total);
+        char label[64];
+        snprintf(label, sizeof(label), "Importing %zu / %zu", done, total);
+        ImGui::ProgressBar(total ? (float)done / (float)total : 1.0f, ImVec2(-1, 0), label);
+    }
+
     ImGui::Separator();
 
     // Asset tree
@@ -933,6 +1079,8 @@ void EditorWindows::drawAssets() {
             ImGui::Text("GUID: %.8s", meta->guid.c_str());
             if (show_asset_refs_) ImGui::Text("References: %d", meta->referenceCount);
             ImGui::Separator();
+            // Solo se guarda y se reimporta cuando un control cambia algo
+            bool changed = false;
             if (meta->assetType == "Texture") {
                 const char* minOpts[] = { "Nearest", "Linear", "Trilinear" };
                 const char* magOpts[] = { "Nearest", "Linear" };
@@ -942,16 +1090,18 @@ void EditorWindows::drawAssets() {
                 if (meta->texMagFilter == "Nearest") magIdx = 0;
                 if (meta->texWrapS == "ClampToEdge") wrapSIdx = 1; else if (meta->texWrapS == "MirroredRepeat") wrapSIdx = 2;
                 if (meta->texWrapT == "ClampToEdge") wrapTIdx = 1; else if (meta->texWrapT == "MirroredRepeat") wrapTIdx = 2;
-                if (ImGui::Combo("Min Filter", &minIdx, minOpts, 3)) meta->texMinFilter = minOpts[minIdx];
-                if (ImGui::Combo("Mag Filter", &magIdx, magOpts, 2)) meta->texMagFilter = magOpts[magIdx];
-                if (ImGui::Combo("Wrap S", &wrapSIdx, wrapOpts, 3)) meta->texWrapS = wrapOpts[wrapSIdx];
-                if (ImGui::Combo("Wrap T", &wrapTIdx, wrapOpts, 3)) meta->texWrapT = wrapOpts[wrapTIdx];
-                ImGui::Checkbox("Flip X", &meta->texFlipX);
-                ImGui::Checkbox("Flip Y", &meta->texFlipY);
-                ImGui::Checkbox("Mipmaps", &meta->texMipmaps);
+                if (ImGui::Combo("Min Filter", &minIdx, minOpts, 3)) { meta->texMinFilter = minOpts[minIdx]; changed = true; }
+                if (ImGui::Combo("Mag Filter", &magIdx, magOpts, 2)) { meta->texMagFilter = magOpts[magIdx]; changed = true; }
+                if (ImGui::Combo("Wrap S", &wrapSIdx, wrapOpts, 3)) { meta->texWrapS = wrapOpts[wrapSIdx]; changed = true; }
+                if (ImGui::Combo("Wrap T", &wrapTIdx, wrapOpts, 3)) { meta->texWrapT = wrapOpts[wrapTIdx]; changed = true; }
+                changed |= ImGui::Checkbox("Flip X", &meta->texFlipX);
+                changed |= ImGui::Checkbox("Flip Y", &meta->texFlipY);
+                changed |= ImGui::Checkbox("Mipmaps", &meta->texMipmaps);
             } else if (meta->assetType == "Model") {
                 float scale = (float)meta->meshScale;
                 if (ImGui::DragFloat("Scale", &scale, 0.01f, 0.0001f, 1000.0f)) meta->meshScale = scale;
+                // Mientras se arrastra no se reimporta; se aplica al soltar
+                changed |= ImGui::IsItemDeactivatedAfterEdit();
                 const char* upOpts[] = { "Y", "Z" };
                 const char* fwdOpts[] = { "+Z", "-Z", "+X", "-X" };
                 int upIdx = meta->axisUp == "Z" ? 1 : 0;
@@ -959,14 +1109,12 @@ void EditorWindows::drawAssets() {
                 if (meta->axisForward == "-Z") fwdIdx = 1;
                 else if (meta->axisForward == "+X") fwdIdx = 2;
                 else if (meta->axisForward == "-X") fwdIdx = 3;
-                if (ImGui::Combo("Up", &upIdx, upOpts, 2)) meta->axisUp = upOpts[upIdx];
-                if (ImGui::Combo("Forward", &fwdIdx, fwdOpts, 4)) meta->axisForward = fwdOpts[fwdIdx];
-                ImGui::Checkbox("Ignore Cameras", &meta->ignoreCameras);
-                ImGui::Checkbox("Ignore Lights", &meta->ignoreLights);
+                if (ImGui::Combo("Up", &upIdx, upOpts, 2)) { meta->axisUp = upOpts[upIdx]; changed = true; }
+                if (ImGui::Combo("Forward", &fwdIdx, fwdOpts, 4)) { meta->axisForward = fwdOpts[fwdIdx]; changed = true; }
+                changed |= ImGui::Checkbox("Ignore Cameras", &meta->ignoreCameras);
+                changed |= ImGui::Checkbox("Ignore Lights", &meta->ignoreLights);
             }
-            std::string metaPath = selected_asset_ + ".meta";
-            AssetMeta::saveToFile(metaPath, *meta);
-            if (asset_database_) asset_database_->refresh();
+            if (changed && asset_database_) asset_database_->saveAssetSettings(*meta);
         }
     }
     ImGui::End();
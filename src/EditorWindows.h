@@ -12,6 +12,9 @@
 
 
 class AssetDatabase; // Forward declaration
+class Octree;        // Forward declaration
+class TransformHierarchy;
+class StaticBatcher;
 
 class EditorWindows {
 public:
@@ -24,10 +27,15 @@ public:
     bool wantsQuit() const { return wants_quit_; }
     bool shouldShowAABBs() const { return show_aabbs_; }
     bool isFrustumCullingEnabled() const { return enable_frustum_culling_; } 
+    bool isOctreeEnabled() const { return use_octree_; }
     bool shouldShowFrustum() const { return show_frustum_; }
 
     // Asset system integration
     void setAssetDatabase(AssetDatabase* db) { asset_database_ = db; }
+    // Spatial index kept in sync with Inspector/Hierarchy edits
+    void setOctree(Octree* octree) { octree_ = octree; }
+    void setTransformHierarchy(TransformHierarchy* transforms) { transforms_ = transforms; }
+    void setStaticBatcher(const StaticBatcher* batcher) { static_batcher_ = batcher; }
 
     void drawAssets();
     void drawToolbar(bool& isPlaying, bool& isPaused, bool& step); // [NEW] Logic for Play/Stop
@@ -69,6 +77,7 @@ private:
     bool wants_quit_ = false;
     bool show_aabbs_ = false;
     bool enable_frustum_culling_ = true;  
+    bool use_octree_ = true;
     bool show_frustum_ = false;
 
     static constexpr int kFpsHistory = 300;
@@ -76,11 +85,21 @@ private:
     int   fps_index_ = 0;
     unsigned int checker_tex_ = 0;
   int checker_w_ = 0, checker_h_ = 0;
-    std::unordered_map<GameObject*, unsigned int> prev_tex_;
+    // Textura propia del objeto antes de Checkerboard/drop, para Restore
+    // owner evita confundir un objeto nuevo con uno borrado en la misma direccion
+    struct PrevTexture {
+        unsigned int id = 0;
+        std::shared_ptr<TextureResource> ref;
+        std::weak_ptr<GameObject> owner;
+    };
+    std::unordered_map<GameObject*, PrevTexture> prev_tex_;
     std::vector<std::shared_ptr<GameObject>>* scene_ = nullptr;
     std::shared_ptr<GameObject>* selected_ = nullptr;
 
     AssetDatabase* asset_database_ = nullptr; // Asset database reference
+    Octree* octree_ = nullptr;
+    TransformHierarchy* transforms_ = nullptr;
+    const StaticBatcher* static_batcher_ = nullptr;
     std::unordered_set<GameObject*> openNodes_;
     GameObject* pendingFocus_ = nullptr;
     bool preserve_world_ = true;
@@ -125,9 +144,13 @@ private:
     void collectPostorder(GameObject* root, std::vector<GameObject*>& out);
     std::shared_ptr<GameObject> findShared(GameObject* raw);
     void removeFromScene(GameObject* raw);
+    // Quita las texturas guardadas de objetos que ya no estan en la escena
+    // (borrados, escena recargada): sus referencias retendrian el asset
+    void prunePrevTextures();
     void reparent(GameObject* dragged, GameObject* target);
     void reorderSibling(GameObject* node, GameObject* parent, int newIndex);
     void reorderRoot(GameObject* node, int newIndex);
 
     void setSelection(const std::shared_ptr<GameObject>& go);
+    void refreshInOctree(GameObject* go);
 };
@@ -8,6 +8,8 @@ Framebuffer::~Framebuffer() {
     if (fboID) glDeleteFramebuffers(1, &fboID);
     if (textureID) glDeleteTextures(1, &textureID);
     if (rboID) glDeleteRenderbuffers(1, &rboID);
+    if (idTextureID) glDeleteTextures(1, &idTextureID);
+    if (depthStencilTextureID) glDeleteTextures(1, &depthStencilTextureID);
 }
 
 void Framebuffer::Init(int w, int h) {
@@ -17,7 +19,10 @@ void Framebuffer::Init(int w, int h) {
     if (fboID) {
         glDeleteFramebuffers(1, &fboID);
         glDeleteTextures(1, &textureID);
-        glDeleteRenderbuffers(1, &rboID);
+        if (rboID) glDeleteRenderbuffers(1, &rboID);
+        if (idTextureID) glDeleteTextures(1, &idTextureID);
+        if (depthStencilTextureID) glDeleteTextures(1, &depthStencilTextureID);
+        rboID = idTextureID = depthStencilTextureID = 0;
     }
 
     glGenFramebuffers(1, &fboID);
@@ -31,11 +36,34 @@ void Framebuffer::Init(int w, int h) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureID, 0);
 
-    // Depth/Stencil Attachment (Renderbuffer)
-    glGenRenderbuffers(1, &rboID);
-    glBindRenderbuffer(GL_RENDERBUFFER, rboID);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, rboID);
+    // ID Attachment (GL_R32UI, solo para picking)
+    if (idEnabled) {
+        glGenTextures(1, &idTextureID);
+        glBindTexture(GL_TEXTURE_2D, idTextureID);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, width, height, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, idTextureID, 0);
+    }
+
+    if (depthStencilTextureEnabled) {
+        // Depth/Stencil Attachment (Texture, stencil sampleable)
+        glGenTextures(1, &depthStencilTextureID);
+        glBindTexture(GL_TEXTURE_2D, depthStencilTextureID);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, width, height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_DEPTH_STENCIL_TEXTURE_MODE, GL_STENCIL_INDEX);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depthStencilTextureID, 0);
+    }
+    else {
+        // Depth/Stencil Attachment (Renderbuffer)
+        glGenRenderbuffers(1, &rboID);
+        glBindRenderbuffer(GL_RENDERBUFFER, rboID);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, rboID);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
 
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
         std::cerr << "ERROR::FRAMEBUFFER:: Framebuffer is not complete!" << std::endl;
@@ -49,6 +77,24 @@ void Framebuffer::Rescale(int w, int h) {
     Init(w, h);
 }
 
+void Framebuffer::EnableIdAttachment(bool enable) {
+    if (idEnabled == enable) return;
+    idEnabled = enable;
+    if (fboID) Init(width, height);
+}
+
+void Framebuffer::EnableDepthStencilTexture(bool enable) {
+    if (depthStencilTextureEnabled == enable) return;
+    depthStencilTextureEnabled = enable;
+    if (fboID) Init(width, height);
+}
+
+void Framebuffer::AttachDepthStencil(bool attach) {
+    if (!depthStencilTextureID) return;
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D,
+        attach ? depthStencilTextureID : 0, 0);
+}
+
 void Framebuffer::Bind() {
     glBindFramebuffer(GL_FRAMEBUFFER, fboID);
     glViewport(0, 0, width, height);
@@ -12,6 +12,17 @@ public:
     void Bind();
     void Unbind();
 
+    // Adjunto entero GL_R32UI en COLOR_ATTACHMENT1 con IDs de objeto (picking por GPU).
+    // Se crea en el proximo Init/Rescale; el draw buffer por defecto sigue siendo el 0
+    void EnableIdAttachment(bool enable);
+    bool HasIdAttachment() const { return idTextureID != 0; }
+    // Depth/stencil en una textura en vez de renderbuffer, con el stencil
+    // muestreable (ARB_stencil_texturing) para el contorno de seleccion
+    void EnableDepthStencilTexture(bool enable);
+    GLuint GetDepthStencilTextureID() const { return depthStencilTextureID; }
+    // Quita y vuelve a poner el depth/stencil: mientras se muestrea no puede estar adjunto
+    void AttachDepthStencil(bool attach);
+
     GLuint GetTextureID() const { return textureID; }
     int GetWidth() const { return width; }
     int GetHeight() const { return height; }
@@ -20,6 +31,10 @@ private:
     GLuint fboID = 0;
     GLuint textureID = 0;
     GLuint rboID = 0;
+    GLuint idTextureID = 0;
+    GLuint depthStencilTextureID = 0;
+    bool idEnabled = false;
+    bool depthStencilTextureEnabled = false;
     int width = 0;
     int height = 0;
 };
@@ -46,6 +46,16 @@ public:
         COUNT
     };
 
+    // Resultado de clasificar una caja contra el frustum
+    enum Containment {
+        OUTSIDE = 0,
+        INTERSECTS,
+        INSIDE
+    };
+
+    // Bit i activo = el plano i todavia hay que comprobarlo
+    static constexpr unsigned ALL_PLANES = (1u << COUNT) - 1u;
+
     Plane planes[COUNT];
 
     Frustum() {}
@@ -106,6 +116,27 @@ public:
         return true;
     }
 
+    // Como containsAABB, pero distingue "dentro del todo" de "cortando".
+    // planeMask entra con los planos a comprobar y sale sin los planos de los que
+    // la caja queda totalmente dentro; los hijos de la caja pueden saltarselos.
+    Containment classifyAABB(const AABB& box, unsigned& planeMask) const {
+        for (int i = 0; i < COUNT; i++) {
+            const unsigned bit = 1u << i;
+            if (!(planeMask & bit)) continue;
+
+            const vec3& n = planes[i].normal;
+            vec3 positiveVertex = box.min;
+            vec3 negativeVertex = box.max;
+            if (n.x >= 0) { positiveVertex.x = box.max.x; negativeVertex.x = box.min.x; }
+            if (n.y >= 0) { positiveVertex.y = box.max.y; negativeVertex.y = box.min.y; }
+            if (n.z >= 0) { positiveVertex.z = box.max.z; negativeVertex.z = box.min.z; }
+
+            if (planes[i].distanceToPoint(positiveVertex) < 0) return OUTSIDE;
+            if (planes[i].distanceToPoint(negativeVertex) >= 0) planeMask &= ~bit;
+        }
+        return planeMask == 0 ? INSIDE : INTERSECTS;
+    }
+
     void getCorners(vec3 corners[8], const mat4& invProjView) const {
         vec4 ndcCorners[8] = {
             vec4(-1, -1, -1, 1), vec4(1, -1, -1, 1),
@@ -0,0 +1,183 @@
+#include "FrustumBatch.h"
+#include <SDL3/SDL.h>
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define MOTOR_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// GCC/Clang necesitan marcar la funcion para poder emitir AVX sin -mavx;
+// MSVC permite los intrinsics directamente.
+#if defined(MOTOR_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MOTOR_TARGET_AVX __attribute__((target("avx")))
+#else
+#define MOTOR_TARGET_AVX
+#endif
+
+/*-------------------------------------------------------------------------
+  AABBBatch
+-------------------------------------------------------------------------*/
+
+void AABBBatch::clear() {
+    minX.clear(); minY.clear(); minZ.clear();
+    maxX.clear(); maxY.clear(); maxZ.clear();
+}
+
+void AABBBatch::reserve(size_t n) {
+    minX.reserve(n); minY.reserve(n); minZ.reserve(n);
+    maxX.reserve(n); maxY.reserve(n); maxZ.reserve(n);
+}
+
+void AABBBatch::push(const AABB& box) {
+    minX.push_back(box.min.x); minY.push_back(box.min.y); minZ.push_back(box.min.z);
+    maxX.push_back(box.max.x); maxY.push_back(box.max.y); maxZ.push_back(box.max.z);
+}
+
+/*-------------------------------------------------------------------------
+  Kernels
+  Todos calculan ((nx*px + ny*py) + nz*pz) + d en el mismo orden que
+  glm::dot + Plane::distance, asi el resultado es identico al escalar.
+-------------------------------------------------------------------------*/
+
+namespace {
+
+// Puntero al array de la componente del p-vertex: max si la normal es >= 0
+struct PlaneSelect {
+    const double* px;
+    const double* py;
+    const double* pz;
+};
+
+inline PlaneSelect selectPVertex(const Plane& p, const AABBBatch& b) {
+    return {
+        p.normal.x >= 0 ? b.maxX.data() : b.minX.data(),
+        p.normal.y >= 0 ? b.maxY.data() : b.minY.data(),
+        p.normal.z >= 0 ? b.maxZ.data() : b.minZ.data()
+    };
+}
+
+void cullRange(const Frustum& frustum, const AABBBatch& batch, uint8_t* visible,
+               size_t begin, size_t end, unsigned planeMask) {
+    for (size_t i = begin; i < end; ++i) visible[i] = 1;
+    for (int p = 0; p < Frustum::COUNT; ++p) {
+        if (!(planeMask & (1u << p))) continue;
+        const Plane& plane = frustum.planes[p];
+        PlaneSelect s = selectPVertex(plane, batch);
+        for (size_t i = begin; i < end; ++i) {
+            double d = plane.normal.x * s.px[i] + plane.normal.y * s.py[i];
+            d = d + plane.normal.z * s.pz[i];
+            d = d + plane.distance;
+            if (d < 0) visible[i] = 0;
+        }
+    }
+}
+
+#ifdef MOTOR_SIMD_X86
+
+size_t cullSSE2(const Frustum& frustum, const AABBBatch& batch, uint8_t* visible, unsigned planeMask) {
+    const size_t count = batch.size() & ~size_t(1);
+    const __m128d zero = _mm_setzero_pd();
+    for (size_t i = 0; i < count; i += 2) {
+        __m128d outside = _mm_setzero_pd();
+        for (int p = 0; p < Frustum::COUNT; ++p) {
+            if (!(planeMask & (1u << p))) continue;
+            const Plane& plane = frustum.planes[p];
+            PlaneSelect s = selectPVertex(plane, batch);
+            __m128d d = _mm_add_pd(_mm_mul_pd(_mm_set1_pd(plane.normal.x), _mm_loadu_pd(s.px + i)),
+                                   _mm_mul_pd(_mm_set1_pd(plane.normal.y), _mm_loadu_pd(s.py + i)));
+            d = _mm_add_pd(d, _mm_mul_pd(_mm_set1_pd(plane.normal.z), _mm_loadu_pd(s.pz + i)));
+            d = _mm_add_pd(d, _mm_set1_pd(plane.distance));
+            outside = _mm_or_pd(outside, _mm_cmplt_pd(d, zero));
+        }
+        int bits = _mm_movemask_pd(outside);
+        visible[i]     = (bits & 1) ? 0 : 1;
+        visible[i + 1] = (bits & 2) ? 0 : 1;
+    }
+    return count;
+}
+
+MOTOR_TARGET_AVX
+size_t cullAVX(const Frustum& frustum, const AABBBatch& batch, uint8_t* visible, unsigned planeMask) {
+    const size_t count = batch.size() & ~size_t(3);
+    const __m256d zero = _mm256_setzero_pd();
+    for (size_t i = 0; i < count; i += 4) {
+        __m256d outside = _mm256_setzero_pd();
+        for (int p = 0; p < Frustum::COUNT; ++p) {
+            if (!(planeMask & (1u << p))) continue;
+            const Plane& plane = frustum.planes[p];
+            PlaneSelect s = selectPVertex(plane, batch);
+            __m256d d = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(plane.normal.x), _mm256_loadu_pd(s.px + i)),
+                                      _mm256_mul_pd(_mm256_set1_pd(plane.normal.y), _mm256_loadu_pd(s.py + i)));
+            d = _mm256_add_pd(d, _mm256_mul_pd(_mm256_set1_pd(plane.normal.z), _mm256_loadu_pd(s.pz + i)));
+            d = _mm256_add_pd(d, _mm256_set1_pd(plane.distance));
+            outside = _mm256_or_pd(outside, _mm256_cmp_pd(d, zero, _CMP_LT_OQ));
+        }
+        int bits = _mm256_movemask_pd(outside);
+        visible[i]     = (bits & 1) ? 0 : 1;
+        visible[i + 1] = (bits & 2) ? 0 : 1;
+        visible[i + 2] = (bits & 4) ? 0 : 1;
+        visible[i + 3] = (bits & 8) ? 0 : 1;
+    }
+    return count;
+}
+
+#endif
+
+using FrustumBatch::Kernel;
+
+Kernel detectKernel() {
+#ifdef MOTOR_SIMD_X86
+    if (SDL_HasAVX()) return Kernel::AVX;
+    return Kernel::SSE2;
+#else
+    return Kernel::Scalar;
+#endif
+}
+
+Kernel activeKernel() {
+    static const Kernel k = detectKernel();
+    return k;
+}
+
+} // namespace
+
+/*-------------------------------------------------------------------------
+  API
+-------------------------------------------------------------------------*/
+
+void FrustumBatch::cullScalar(const Frustum& frustum, const AABBBatch& batch, std::vector<uint8_t>& visible, unsigned planeMask) {
+    visible.resize(batch.size());
+    cullRange(frustum, batch, visible.data(), 0, batch.size(), planeMask);
+}
+
+bool FrustumBatch::cullWith(Kernel kernel, const Frustum& frustum, const AABBBatch& batch, std::vector<uint8_t>& visible, unsigned planeMask) {
+#ifdef MOTOR_SIMD_X86
+    if (kernel == Kernel::AVX && activeKernel() != Kernel::AVX) return false;
+#else
+    if (kernel != Kernel::Scalar) return false;
+#endif
+    visible.resize(batch.size());
+    size_t done = 0;
+#ifdef MOTOR_SIMD_X86
+    switch (kernel) {
+    case Kernel::AVX:  done = cullAVX(frustum, batch, visible.data(), planeMask); break;
+    case Kernel::SSE2: done = cullSSE2(frustum, batch, visible.data(), planeMask); break;
+    default: break;
+    }
+#endif
+    // Resto (o todo, sin SIMD) por la via escalar
+    cullRange(frustum, batch, visible.data(), done, batch.size(), planeMask);
+    return true;
+}
+
+void FrustumBatch::cull(const Frustum& frustum, const AABBBatch& batch, std::vector<uint8_t>& visible, unsigned planeMask) {
+    cullWith(activeKernel(), frustum, batch, visible, planeMask);
+}
+
+const char* FrustumBatch::kernelName() {
+    switch (activeKernel()) {
+    case Kernel::AVX:  return "AVX (4 AABB)";
+    case Kernel::SSE2: return "SSE2 (2 AABB)";
+    default:           return "Scalar";
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "AABB.h"
+#include "Frustum.h"
+#include <vector>
+#include <cstdint>
+
+// Lote de AABBs en formato SoA (structure of arrays): cada componente en su
+// propio array contiguo, para testear varias cajas a la vez con SIMD.
+struct AABBBatch {
+    std::vector<double> minX, minY, minZ;
+    std::vector<double> maxX, maxY, maxZ;
+
+    void clear();
+    void reserve(size_t n);
+    void push(const AABB& box);
+    size_t size() const { return minX.size(); }
+};
+
+namespace FrustumBatch {
+    enum class Kernel { Scalar, SSE2, AVX };
+
+    // visible[i] = 1 si la caja i pasa el test, con el mismo criterio que
+    // Frustum::containsAABB (p-vertex contra cada plano del mask).
+    // Elige en runtime el kernel AVX (4 cajas), SSE2 (2 cajas) o escalar.
+    void cull(const Frustum& frustum, const AABBBatch& batch, std::vector<uint8_t>& visible,
+              unsigned planeMask = Frustum::ALL_PLANES);
+
+    // Version escalar de referencia; tambien procesa el resto que no llena un registro
+    void cullScalar(const Frustum& frustum, const AABBBatch& batch, std::vector<uint8_t>& visible,
+                    unsigned planeMask = Frustum::ALL_PLANES);
+
+    // Con un kernel concreto, para comprobarlo contra cullScalar (tests/). false,
+    // sin tocar visible, si esta CPU o arquitectura no lo soporta
+    bool cullWith(Kernel kernel, const Frustum& frustum, const AABBBatch& batch, std::vector<uint8_t>& visible,
+                  unsigned planeMask = Frustum::ALL_PLANES);
+
+    const char* kernelName();
+}
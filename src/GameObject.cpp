@@ -1,6 +1,6 @@
 #include "GameObject.h"
+#include "TextureLoader.h"
 #include <GL/glew.h>
-#include <glm/gtc/type_ptr.hpp>
 #include <algorithm>
 #include <vector>
 #include <glm/gtc/matrix_inverse.hpp>
@@ -8,38 +8,37 @@
 GameObject::GameObject(const std::string& n) : name(n) {
 }
 
-void GameObject::draw() const {
-    if (!mesh) return;
-    glPushMatrix();
-    glMultMatrixd(glm::value_ptr(computeWorldMatrix(this)));
-    if (isSelected) {
-        glDisable(GL_LIGHTING);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-        glLineWidth(3.0f);
-        glColor3f(1.0f, 1.0f, 0.0f);
-        mesh->draw();
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-        glLineWidth(1.0f);
-        glEnable(GL_LIGHTING);
-    }
-    mesh->draw();
-    glPopMatrix();
-}
-
 void GameObject::setMesh(std::shared_ptr<Mesh> m) {
     mesh = m;
 }
 
 void GameObject::setTexture(GLuint texID) {
-    if (mesh) {
-        mesh->setTexture(texID);
-    }
+    _textureOverride = texID;
+    _textureRef.reset();
+}
+
+void GameObject::setTexture(std::shared_ptr<TextureResource> tex) {
+    _textureOverride = tex ? tex->id : 0;
+    _textureRef = std::move(tex);
 }
+
 unsigned int GameObject::getTextureID() const {
+    if (_textureOverride) return _textureOverride;
     if (!mesh) return 0;
     return mesh->getTextureID(); 
 }
 
+bool GameObject::raycast(const Ray& worldRay, MeshBVH::Hit& hit) const {
+    if (!mesh) return false;
+    mat4 invWorld = glm::inverse(worldMatrix());
+
+    // Sin normalizar la direccion, t es el mismo en espacio local y en mundo
+    Ray localRay;
+    localRay.origin = vec3(invWorld * vec4(worldRay.origin, 1.0));
+    localRay.direction = vec3(invWorld * vec4(worldRay.direction, 0.0));
+    return mesh->raycast(localRay, hit);
+}
+
 bool GameObject::isDescendantOf(const GameObject* p) const {
     for (auto cur = parent; cur; cur = cur->parent)
         if (cur == p) return true;
@@ -81,13 +80,47 @@ void GameObject::removeChild(GameObject* c) {
     }
 }
 
-mat4 computeWorldMatrix(const GameObject* go) {
-    mat4 M(1.0);
-    std::vector<const GameObject*> chain;
-    for (auto cur = go; cur; cur = cur->parent) chain.push_back(cur);
-    for (auto it = chain.rbegin(); it != chain.rend(); ++it)
-        M = M * (*it)->transform.mat();
-    return M;
+const mat4& GameObject::worldMatrix() const {
+    uint64_t parentStamp = 0;
+    if (parent) {
+        parent->worldMatrix(); // Valida (y si hace falta recalcula) la cadena de ancestros
+        parentStamp = parent->_worldStamp;
+    }
+    if (_cachedLocalVersion != transform.version() || _cachedParent != parent || _cachedParentStamp != parentStamp) {
+        _world = parent ? parent->_world * transform.mat() : transform.mat();
+        _worldStamp = Transform::nextVersion();
+        _cachedLocalVersion = transform.version();
+        _cachedParent = parent;
+        _cachedParentStamp = parentStamp;
+    }
+    return _world;
+}
+
+void GameObject::setCachedWorld(const mat4& world, uint64_t stamp) const {
+    _world = world;
+    _worldStamp = stamp;
+    _cachedLocalVersion = transform.version();
+    _cachedParent = parent;
+    _cachedParentStamp = parent ? parent->_worldStamp : 0;
+}
+
+const AABB& GameObject::worldAABB() const {
+    const mat4& M = worldMatrix();
+    if (!mesh) {
+        _worldAABB = AABB();
+        _aabbMesh = nullptr;
+        return _worldAABB;
+    }
+    if (_aabbWorldStamp != _worldStamp || _aabbMesh != mesh.get()) {
+        _worldAABB = mesh->getWorldAABB(M);
+        _aabbWorldStamp = _worldStamp;
+        _aabbMesh = mesh.get();
+    }
+    return _worldAABB;
+}
+
+const mat4& computeWorldMatrix(const GameObject* go) {
+    return go->worldMatrix();
 }
 
 void setLocalFromWorld(GameObject* go, const mat4& M_world, const GameObject* newParent) {
@@ -4,6 +4,9 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <cstdint>
+
+struct TextureResource;
 
 class GameObject {
 public:
@@ -11,10 +14,15 @@ public:
     Transform transform;
     std::shared_ptr<Mesh> mesh;
     bool isSelected = false;
+    bool isStatic = false; // No se mueve en juego: puede ir a un lote estatico (StaticBatcher)
+    bool meshLoading = false; // Placeholder: el mesh lo esta cargando AsyncModelLoader
 
     GameObject* parent = nullptr;
     std::vector<GameObject*> children;
 
+    uint32_t octreeHandle = 0xFFFFFFFFu; // Handle en el Octree (back-pointer a su nodo)
+    uint32_t staticBatchHandle = 0xFFFFFFFFu; // Rango en StaticBatcher, si esta en un lote
+
     std::string modelPath; // For simple serialization
     int meshIndex = -1;    // For simple serialization
 
@@ -28,16 +36,49 @@ public:
     CameraComponent camera;
 
     GameObject(const std::string& n = "GameObject");
-    void draw() const;
     void setMesh(std::shared_ptr<Mesh> m);
+    // Textura propia del objeto, por encima de la del mesh: los Mesh se comparten
+    // entre objetos (ResourceManager) y no se tocan. 0 vuelve a la del mesh
     void setTexture(GLuint texID);
+    void setTexture(std::shared_ptr<TextureResource> tex);
+    GLuint textureOverride() const { return _textureOverride; }
+    const std::shared_ptr<TextureResource>& textureRef() const { return _textureRef; }
     unsigned int getTextureID() const;
+    // Picking exacto contra los triangulos del mesh. hit.t entra como distancia
+    // maxima y sale como distancia en mundo (en unidades de worldRay.direction)
+    bool raycast(const Ray& worldRay, MeshBVH::Hit& hit) const;
+
+    // Matriz y AABB de mundo cacheadas. Se recalculan solo si cambio el Transform
+    // propio o el de algun ancestro, o el padre; comprobarlo son O(profundidad)
+    // comparaciones de enteros, sin productos de matrices.
+    const mat4& worldMatrix() const;
+    const AABB& worldAABB() const;
+    // Cambia cada vez que la matriz de mundo se recalcula
+    uint64_t worldStamp() const { worldMatrix(); return _worldStamp; }
+    // Para TransformHierarchy: instala una matriz de mundo calculada fuera. El
+    // padre ya tiene que estar actualizado; stamp debe ser una version nueva.
+    void setCachedWorld(const mat4& world, uint64_t stamp) const;
 
     bool isDescendantOf(const GameObject* p) const;
     int indexInParent() const;
     void addChild(GameObject* c, int index = -1);
     void removeChild(GameObject* c);
+
+private:
+    GLuint _textureOverride = 0;
+    std::shared_ptr<TextureResource> _textureRef;
+
+    mutable mat4 _world = mat4(1.0);
+    mutable uint64_t _worldStamp = 0;        // Nuevo valor cada vez que _world se recalcula
+    mutable uint64_t _cachedLocalVersion = 0; // 0 = nunca calculada
+    mutable uint64_t _cachedParentStamp = 0;
+    mutable const GameObject* _cachedParent = nullptr;
+
+    mutable AABB _worldAABB;
+    mutable uint64_t _aabbWorldStamp = 0;
+    mutable const Mesh* _aabbMesh = nullptr;
 };
 
-mat4 computeWorldMatrix(const GameObject* go);
+// Equivale a go->worldMatrix(); se mantiene por compatibilidad
+const mat4& computeWorldMatrix(const GameObject* go);
 void setLocalFromWorld(GameObject* go, const mat4& M_world, const GameObject* newParent);
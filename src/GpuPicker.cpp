@@ -0,0 +1,176 @@
+#include "GpuPicker.h"
+#include "Renderer.h"
+#include "Framebuffer.h"
+#include "GameObject.h"
+#include "Logger.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <string>
+
+static const char* kPickVertexShader = R"(#version 330 core
+layout(location = 0) in vec3 aPosition;
+uniform mat4 uMVP;
+void main() {
+    gl_Position = uMVP * vec4(aPosition, 1.0);
+}
+)";
+
+static const char* kPickFragmentShader = R"(#version 330 core
+uniform uint uId;
+out uint outId;
+void main() {
+    outId = uId;
+}
+)";
+
+static GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+    GLint ok = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024] = { 0 };
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        LOG_ERROR(std::string("Picking shader error: ") + log);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+GpuPicker& GpuPicker::instance() {
+    static GpuPicker g;
+    return g;
+}
+
+bool GpuPicker::init() {
+    if (!Renderer::instance().isShader()) return false;
+    if (!buildProgram()) {
+        LOG_WARN("GPU picking disabled, using CPU raycast");
+        return false;
+    }
+    glGenBuffers(1, &pbo_);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo_);
+    glBufferData(GL_PIXEL_PACK_BUFFER, sizeof(GLuint), nullptr, GL_STREAM_READ);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return true;
+}
+
+bool GpuPicker::buildProgram() {
+    GLuint vs = compileShader(GL_VERTEX_SHADER, kPickVertexShader);
+    GLuint fs = compileShader(GL_FRAGMENT_SHADER, kPickFragmentShader);
+    if (!vs || !fs) {
+        if (vs) glDeleteShader(vs);
+        if (fs) glDeleteShader(fs);
+        return false;
+    }
+    program_ = glCreateProgram();
+    glAttachShader(program_, vs);
+    glAttachShader(program_, fs);
+    glLinkProgram(program_);
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+    GLint ok = GL_FALSE;
+    glGetProgramiv(program_, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        glDeleteProgram(program_);
+        program_ = 0;
+        return false;
+    }
+    uMVP_ = glGetUniformLocation(program_, "uMVP");
+    uId_ = glGetUniformLocation(program_, "uId");
+    return true;
+}
+
+void GpuPicker::shutdown() {
+    if (fence_) { glDeleteSync(fence_); fence_ = 0; }
+    if (pbo_) { glDeleteBuffers(1, &pbo_); pbo_ = 0; }
+    if (program_) { glDeleteProgram(program_); program_ = 0; }
+    objects_.clear();
+    requested_ = pending_ = false;
+}
+
+void GpuPicker::request(int x, int y) {
+    // Si ya hay una lectura en vuelo, este pick sale en cuanto termine
+    x_ = x;
+    y_ = y;
+    requested_ = true;
+}
+
+Frustum GpuPicker::pixelFrustum(const mat4& viewProj, int width, int height) const {
+    // Como gluPickMatrix con una region de 1x1 centrada en el pixel
+    const double cx = x_ + 0.5;
+    const double cy = (height - 1 - y_) + 0.5;
+    mat4 pick(1.0);
+    pick[0][0] = width;
+    pick[1][1] = height;
+    pick[3][0] = width - 2.0 * cx;
+    pick[3][1] = height - 2.0 * cy;
+    Frustum f;
+    f.extractFromCamera(pick * viewProj);
+    return f;
+}
+
+void GpuPicker::renderPass(const Framebuffer& fb, const mat4& viewProj, const std::vector<GameObject*>& candidates) {
+    if (!wantsPass() || !fb.HasIdAttachment()) return;
+    requested_ = false;
+    const int px = x_;
+    const int py = fb.GetHeight() - 1 - y_;
+    if (px < 0 || py < 0 || px >= fb.GetWidth() || py >= fb.GetHeight()) return;
+
+    // Solo el adjunto de IDs y solo el pixel del cursor. El depth de ese pixel
+    // se limpia: la pasada de escena ya ha terminado
+    glDrawBuffer(GL_COLOR_ATTACHMENT1);
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(px, py, 1, 1);
+    const GLuint zero[4] = { 0, 0, 0, 0 };
+    glClearBufferuiv(GL_COLOR, 0, zero);
+    glClear(GL_DEPTH_BUFFER_BIT);
+    glEnable(GL_DEPTH_TEST);
+
+    glUseProgram(program_);
+    objects_.clear();
+    for (const GameObject* go : candidates) {
+        if (!go->mesh || go->mesh->VAO == 0) continue;
+        objects_.push_back(go);
+        glm::mat4 mvp(viewProj * go->worldMatrix());
+        glUniformMatrix4fv(uMVP_, 1, GL_FALSE, glm::value_ptr(mvp));
+        glUniform1ui(uId_, (GLuint)objects_.size());
+        glBindVertexArray(go->mesh->VAO);
+        go->mesh->drawBound();
+    }
+    glBindVertexArray(0);
+    glUseProgram(0);
+    glDisable(GL_SCISSOR_TEST);
+    glDrawBuffer(GL_COLOR_ATTACHMENT0);
+
+    // Lectura al PBO; el valor se recoge en poll cuando la GPU haya llegado al fence
+    glReadBuffer(GL_COLOR_ATTACHMENT1);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo_);
+    glReadPixels(px, py, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    fence_ = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    pending_ = true;
+    waitedFrames_ = 0;
+}
+
+bool GpuPicker::poll(const GameObject*& hit) {
+    if (!pending_) return false;
+    GLenum r = glClientWaitSync(fence_, 0, 0);
+    if (r == GL_TIMEOUT_EXPIRED) {
+        ++waitedFrames_;
+        return false;
+    }
+    glDeleteSync(fence_);
+    fence_ = 0;
+    pending_ = false;
+    lastLatency_ = waitedFrames_ + 1;
+
+    GLuint id = 0;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo_);
+    glGetBufferSubData(GL_PIXEL_PACK_BUFFER, 0, sizeof(id), &id);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    hit = (id > 0 && id <= objects_.size()) ? objects_[id - 1] : nullptr;
+    return true;
+}
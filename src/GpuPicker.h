@@ -0,0 +1,62 @@
+#pragma once
+#include "types.h"
+#include "Frustum.h"
+#include <GL/glew.h>
+#include <vector>
+
+class GameObject;
+class Framebuffer;
+
+// Picking por GPU: pinta IDs de objeto en el adjunto entero del Framebuffer de
+// escena, solo en el pixel del cursor (scissor 1x1), y lo lee con un PBO unas
+// frames despues sin parar el pipeline. Los candidatos salen de un frustum de
+// un pixel, asi que el coste no depende del tamano de la escena.
+// Necesita el renderer GLSL; en legacy se sigue usando el raycast por CPU.
+class GpuPicker {
+public:
+    static GpuPicker& instance();
+
+    // Llamar despues de Renderer::init
+    bool init();
+    void shutdown();
+
+    bool isAvailable() const { return program_ != 0; }
+    bool isEnabled() const { return enabled_ && isAvailable(); }
+    void setEnabled(bool enabled) { enabled_ = enabled; }
+
+    // Pide el pick del pixel (x, y) del framebuffer, con origen arriba a la izquierda
+    void request(int x, int y);
+    // Hay un pick por dibujar y ninguna lectura en vuelo
+    bool wantsPass() const { return requested_ && !pending_; }
+    // Frustum que cubre solo el pixel pedido, para elegir candidatos
+    Frustum pixelFrustum(const mat4& viewProj, int width, int height) const;
+    // Dibuja los IDs con el framebuffer de escena enlazado y lanza la lectura
+    void renderPass(const Framebuffer& fb, const mat4& viewProj, const std::vector<GameObject*>& candidates);
+    // True cuando la lectura ha terminado; hit es nullptr si el pixel estaba vacio
+    bool poll(const GameObject*& hit);
+
+    int lastLatencyFrames() const { return lastLatency_; }
+    int lastCandidateCount() const { return (int)objects_.size(); }
+
+private:
+    GpuPicker() = default;
+    GpuPicker(const GpuPicker&) = delete;
+    GpuPicker& operator=(const GpuPicker&) = delete;
+
+    bool buildProgram();
+
+    GLuint program_ = 0;
+    GLint uMVP_ = -1;
+    GLint uId_ = -1;
+    GLuint pbo_ = 0;
+    GLsync fence_ = 0;
+    bool enabled_ = true;
+    bool requested_ = false;
+    bool pending_ = false;
+    int x_ = 0;
+    int y_ = 0;
+    int waitedFrames_ = 0;
+    int lastLatency_ = 0;
+    // ID - 1 -> objeto; se guarda hasta que llega la lectura
+    std::vector<const GameObject*> objects_;
+};
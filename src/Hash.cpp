@@ -0,0 +1,117 @@
+#include "Hash.h"
+#include "MappedFile.h"
+#include <cstring>
+#include <system_error>
+#include <filesystem>
+
+static const uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+static const uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// Lecturas sin alinear; el formato es little endian como el de referencia
+static inline uint64_t read64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t round(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    acc = rotl(acc, 31);
+    return acc * kPrime1;
+}
+
+static inline uint64_t mergeRound(uint64_t acc, uint64_t val) {
+    acc ^= round(0, val);
+    return acc * kPrime1 + kPrime4;
+}
+
+uint64_t Hash64(const void* data, size_t size, uint64_t seed) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* const end = p + size;
+    uint64_t h;
+
+    if (size >= 32) {
+        // Cuatro acumuladores independientes por bloque de 32 bytes
+        const uint8_t* const limit = end - 32;
+        uint64_t v1 = seed + kPrime1 + kPrime2;
+        uint64_t v2 = seed + kPrime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - kPrime1;
+        do {
+            v1 = round(v1, read64(p)); p += 8;
+            v2 = round(v2, read64(p)); p += 8;
+            v3 = round(v3, read64(p)); p += 8;
+            v4 = round(v4, read64(p)); p += 8;
+        } while (p <= limit);
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = mergeRound(h, v1);
+        h = mergeRound(h, v2);
+        h = mergeRound(h, v3);
+        h = mergeRound(h, v4);
+    }
+    else {
+        h = seed + kPrime5;
+    }
+    h += (uint64_t)size;
+
+    while (p + 8 <= end) {
+        h ^= round(0, read64(p));
+        h = rotl(h, 27) * kPrime1 + kPrime4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= (uint64_t)read32(p) * kPrime1;
+        h = rotl(h, 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (*p) * kPrime5;
+        h = rotl(h, 11) * kPrime1;
+        ++p;
+    }
+
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+bool HashFile(const std::string& path, uint64_t& outHash) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    if (size == 0) {
+        outHash = Hash64(nullptr, 0);
+        return true;
+    }
+    MappedFile file;
+    if (!file.open(path)) return false;
+    outHash = Hash64(file.data(), file.size());
+    return true;
+}
+
+HashBuilder& HashBuilder::add(const void* data, size_t size) {
+    bytes_.append(static_cast<const char*>(data), size);
+    return *this;
+}
+
+HashBuilder& HashBuilder::add(const std::string& s) {
+    // Con la longitud delante, "ab"+"c" y "a"+"bc" no dan lo mismo
+    add((uint64_t)s.size());
+    return add(s.data(), s.size());
+}
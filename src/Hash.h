@@ -0,0 +1,25 @@
+#pragma once
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// XXH64 (xxHash de 64 bits): rapido y con buena dispersion, no criptografico.
+// Se usa para detectar cambios en los fuentes de Assets y en las claves de importacion.
+uint64_t Hash64(const void* data, size_t size, uint64_t seed = 0);
+
+// Hash del contenido de un fichero, leido con un mapeo en memoria
+bool HashFile(const std::string& path, uint64_t& outHash);
+
+// Acumula campos sueltos (numeros, cadenas) y los hashea de una vez
+class HashBuilder {
+public:
+    HashBuilder& add(const void* data, size_t size);
+    HashBuilder& add(const std::string& s);
+    HashBuilder& add(uint64_t v) { return add(&v, sizeof(v)); }
+    HashBuilder& add(double v) { return add(&v, sizeof(v)); }
+    HashBuilder& add(bool v) { uint8_t b = v ? 1 : 0; return add(&b, 1); }
+    uint64_t finish(uint64_t seed = 0) const { return Hash64(bytes_.data(), bytes_.size(), seed); }
+
+private:
+    std::string bytes_;
+};
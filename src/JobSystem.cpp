@@ -0,0 +1,96 @@
+#include "JobSystem.h"
+#include <SDL3/SDL.h>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+JobSystem& JobSystem::instance() {
+    static JobSystem g;
+    return g;
+}
+
+JobSystem::JobSystem() {
+    // Un hilo por core menos el principal, que tambien trabaja en parallelFor
+    // SDL no necesita SDL_Init para esto; el pool puede crearse antes
+    int cores = SDL_GetNumLogicalCPUCores();
+    if (cores < 1) cores = (int)std::thread::hardware_concurrency();
+    size_t count = cores > 1 ? (size_t)cores - 1 : 1;
+    workers_.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        workers_.emplace_back(&JobSystem::workerLoop, this);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+void JobSystem::workerLoop() {
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (stop_ && queue_.empty()) return;
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        job();
+    }
+}
+
+void JobSystem::submit(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        queue_.push_back(std::move(job));
+    }
+    cv_.notify_one();
+}
+
+void JobSystem::parallelFor(size_t count, size_t minBatch, const std::function<void(size_t, size_t)>& fn) {
+    if (count == 0) return;
+    minBatch = std::max<size_t>(minBatch, 1);
+    const size_t maxChunks = workers_.size() + 1;
+    const size_t chunks = std::min(maxChunks, (count + minBatch - 1) / minBatch);
+    if (chunks <= 1) {
+        fn(0, count);
+        return;
+    }
+
+    // Estado compartido con los helpers. Un helper que arranque tarde (la cola
+    // puede estar ocupada con otras tareas) ya no encuentra trozos y sale sin
+    // tocar fn, por eso el llamador solo espera a que se completen los trozos.
+    struct State {
+        const std::function<void(size_t, size_t)>* fn;
+        size_t count, chunks;
+        std::atomic<size_t> next{ 0 };
+        size_t done = 0;
+        std::mutex mtx;
+        std::condition_variable cv;
+    };
+    auto state = std::make_shared<State>();
+    state->fn = &fn;
+    state->count = count;
+    state->chunks = chunks;
+
+    auto run = [](State& s) {
+        for (size_t c = s.next.fetch_add(1); c < s.chunks; c = s.next.fetch_add(1)) {
+            size_t begin = s.count * c / s.chunks;
+            size_t end = s.count * (c + 1) / s.chunks;
+            (*s.fn)(begin, end);
+            std::lock_guard<std::mutex> lock(s.mtx);
+            if (++s.done == s.chunks) s.cv.notify_all();
+        }
+    };
+
+    for (size_t i = 0; i + 1 < chunks; ++i)
+        submit([state, run] { run(*state); });
+    run(*state);
+
+    std::unique_lock<std::mutex> lock(state->mtx);
+    state->cv.wait(lock, [&] { return state->done == state->chunks; });
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Pool de hilos compartido por todo el motor. Los workers sacan tareas de una
+// cola comun; parallelFor ademas hace trabajar al hilo que lo llama.
+class JobSystem {
+public:
+    static JobSystem& instance();
+
+    // Ejecuta fn(begin, end) sobre [0, count) en trozos de al menos minBatch
+    // elementos y bloquea hasta que todos han terminado. Con pocos elementos
+    // lo hace todo el hilo llamador, sin pasar por la cola.
+    void parallelFor(size_t count, size_t minBatch, const std::function<void(size_t, size_t)>& fn);
+
+    // Encola una tarea suelta; se ejecuta en algun worker
+    void submit(std::function<void()> job);
+
+    size_t workerCount() const { return workers_.size(); }
+
+private:
+    JobSystem();
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void workerLoop();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> queue_;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// Fichero mapeado en memoria, solo lectura. Las paginas se cargan al tocarlas:
+// abrir un blob grande no lo lee entero. Win32 (CreateFileMapping) o POSIX (mmap).
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return data_ != nullptr; }
+    const uint8_t* data() const { return static_cast<const uint8_t*>(data_); }
+    size_t size() const { return size_; }
+
+private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;    // HANDLE
+    void* mapping_ = nullptr; // HANDLE
+#else
+    int fd_ = -1;
+#endif
+};
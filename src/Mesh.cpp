@@ -1,5 +1,12 @@
 ﻿#include "Mesh.h"
+#include "MeshArena.h"
+#include "MeshBlob.h"
+#include "DebugDraw.h"
+#include "TextureLoader.h"
 #include <cstddef>
+#include <cmath>
+#include <atomic>
+#include <glm/gtc/packing.hpp>
 
 Mesh::Mesh(const std::vector<Vertex>& verts, const std::vector<unsigned int>& inds)
     : vertices(verts), indices(inds) {
@@ -9,89 +16,318 @@ Mesh::~Mesh() {
     cleanup();
 }
 
-void Mesh::setupMesh() {
-    if (_isSetup || vertices.empty()) return;
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER,
-        static_cast<GLsizeiptr>(vertices.size() * sizeof(Vertex)),
-        vertices.data(),
-        GL_STATIC_DRAW);
-    if (!indices.empty()) {
-        glGenBuffers(1, &EBO);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-            static_cast<GLsizeiptr>(indices.size() * sizeof(unsigned int)),
-            indices.data(),
-            GL_STATIC_DRAW);
+static_assert(sizeof(PackedVertex) == 20, "PackedVertex debe ocupar 20 bytes");
+
+// Por encima de este valor las UV en half pierden mas de un texel en texturas de 1024
+static const float kMaxPackedUV = 2.0f;
+
+static std::atomic<size_t> s_cpuBytes{ 0 };
+static std::atomic<size_t> s_gpuBytes{ 0 };
+static std::atomic<size_t> s_doubleLayoutBytes{ 0 };
+static std::atomic<size_t> s_packedMeshes{ 0 };
+static std::atomic<size_t> s_floatMeshes{ 0 };
+
+static bool packedFormatsSupported() {
+    // Normal 2_10_10_10 y UV half en glNormalPointer/glTexCoordPointer: core en 3.3 compat
+    return GLEW_VERSION_3_3 || (GLEW_ARB_vertex_type_2_10_10_10_rev && GLEW_ARB_half_float_vertex);
+}
+
+MeshMemoryStats Mesh::memoryStats() {
+    MeshMemoryStats st;
+    st.cpuBytes = s_cpuBytes;
+    st.gpuBytes = s_gpuBytes;
+    st.doubleLayoutBytes = s_doubleLayoutBytes;
+    st.packedMeshes = s_packedMeshes;
+    st.floatMeshes = s_floatMeshes;
+    return st;
+}
+
+void Mesh::packVertices(const std::vector<Vertex>& vertices, std::vector<PackedVertex>& out) {
+    out.resize(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const Vertex& v = vertices[i];
+        PackedVertex& p = out[i];
+        p.position[0] = (float)v.position.x;
+        p.position[1] = (float)v.position.y;
+        p.position[2] = (float)v.position.z;
+        p.normal = glm::packSnorm3x10_1x2(glm::vec4(v.normal, 0.0f));
+        p.texCoord = glm::packHalf2x16(v.texCoord);
+    }
+}
+
+void Mesh::floatVertices(const std::vector<Vertex>& vertices, std::vector<FloatVertex>& out) {
+    out.resize(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const Vertex& v = vertices[i];
+        FloatVertex& f = out[i];
+        f.position[0] = (float)v.position.x;
+        f.position[1] = (float)v.position.y;
+        f.position[2] = (float)v.position.z;
+        f.normal[0] = v.normal.x;
+        f.normal[1] = v.normal.y;
+        f.normal[2] = v.normal.z;
+        f.texCoord[0] = v.texCoord.x;
+        f.texCoord[1] = v.texCoord.y;
+    }
+}
+
+void Mesh::unpackVertices(const void* data, size_t count, bool packed, std::vector<Vertex>& out) {
+    out.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        Vertex& v = out[i];
+        if (packed) {
+            const PackedVertex& p = static_cast<const PackedVertex*>(data)[i];
+            v.position = vec3(p.position[0], p.position[1], p.position[2]);
+            v.normal = glm::vec3(glm::unpackSnorm3x10_1x2(p.normal));
+            v.texCoord = glm::unpackHalf2x16(p.texCoord);
+        }
+        else {
+            const FloatVertex& f = static_cast<const FloatVertex*>(data)[i];
+            v.position = vec3(f.position[0], f.position[1], f.position[2]);
+            v.normal = glm::vec3(f.normal[0], f.normal[1], f.normal[2]);
+            v.texCoord = glm::vec2(f.texCoord[0], f.texCoord[1]);
+        }
     }
+}
+
+bool Mesh::fitsPackedFormat(const std::vector<Vertex>& vertices) {
+    for (const auto& v : vertices) {
+        if (std::abs(v.texCoord.x) > kMaxPackedUV || std::abs(v.texCoord.y) > kMaxPackedUV)
+            return false;
+    }
+    return true;
+}
+
+GpuGeometry Mesh::uploadGeometry(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices) {
+    if (vertices.empty()) return GpuGeometry();
+
+    // Convertir al formato de GPU solo para la subida; en CPU quedan los Vertex
+    const bool packed = packedFormatsSupported() && fitsPackedFormat(vertices);
+    std::vector<PackedVertex> packedData;
+    std::vector<FloatVertex> floatData;
+    if (packed) {
+        packVertices(vertices, packedData);
+        return uploadVertexData(packedData.data(), vertices.size(), true, indices.data(), indices.size());
+    }
+    floatVertices(vertices, floatData);
+    return uploadVertexData(floatData.data(), vertices.size(), false, indices.data(), indices.size());
+}
+
+// Punteros legacy y genericos 0/1/2 sobre el VAO y GL_ARRAY_BUFFER enlazados;
+// base es el byte del primer vertice dentro del VBO
+static void setVertexPointers(bool packed, size_t base) {
     glEnableClientState(GL_VERTEX_ARRAY);
-    glVertexPointer(3, GL_DOUBLE, sizeof(Vertex),
-        reinterpret_cast<const void*>(offsetof(Vertex, position)));
     glEnableClientState(GL_NORMAL_ARRAY);
-    glNormalPointer(GL_DOUBLE, sizeof(Vertex),
-        reinterpret_cast<const void*>(offsetof(Vertex, normal)));
     glClientActiveTexture(GL_TEXTURE0);
     glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-    glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex),
-        reinterpret_cast<const void*>(offsetof(Vertex, texCoord)));
+    if (packed) {
+        glVertexPointer(3, GL_FLOAT, sizeof(PackedVertex),
+            reinterpret_cast<const void*>(base + offsetof(PackedVertex, position)));
+        glNormalPointer(GL_INT_2_10_10_10_REV, sizeof(PackedVertex),
+            reinterpret_cast<const void*>(base + offsetof(PackedVertex, normal)));
+        glTexCoordPointer(2, GL_HALF_FLOAT, sizeof(PackedVertex),
+            reinterpret_cast<const void*>(base + offsetof(PackedVertex, texCoord)));
+    }
+    else {
+        glVertexPointer(3, GL_FLOAT, sizeof(FloatVertex),
+            reinterpret_cast<const void*>(base + offsetof(FloatVertex, position)));
+        glNormalPointer(GL_FLOAT, sizeof(FloatVertex),
+            reinterpret_cast<const void*>(base + offsetof(FloatVertex, normal)));
+        glTexCoordPointer(2, GL_FLOAT, sizeof(FloatVertex),
+            reinterpret_cast<const void*>(base + offsetof(FloatVertex, texCoord)));
+    }
+    // Los mismos datos como atributos genericos 0/1/2 para el renderer GLSL
+    if (GLEW_VERSION_3_3) {
+        glEnableVertexAttribArray(0);
+        glEnableVertexAttribArray(1);
+        glEnableVertexAttribArray(2);
+        if (packed) {
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(PackedVertex),
+                reinterpret_cast<const void*>(base + offsetof(PackedVertex, position)));
+            glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(PackedVertex),
+                reinterpret_cast<const void*>(base + offsetof(PackedVertex, normal)));
+            glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex),
+                reinterpret_cast<const void*>(base + offsetof(PackedVertex, texCoord)));
+        }
+        else {
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(FloatVertex),
+                reinterpret_cast<const void*>(base + offsetof(FloatVertex, position)));
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(FloatVertex),
+                reinterpret_cast<const void*>(base + offsetof(FloatVertex, normal)));
+            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(FloatVertex),
+                reinterpret_cast<const void*>(base + offsetof(FloatVertex, texCoord)));
+        }
+    }
+}
+
+GpuGeometry Mesh::uploadVertexData(const void* data, size_t vertexCount, bool packed,
+    const unsigned int* indices, size_t indexCount) {
+    GpuGeometry geo;
+    if (!data || vertexCount == 0) return geo;
+    const size_t stride = packed ? sizeof(PackedVertex) : sizeof(FloatVertex);
+
+    glGenVertexArrays(1, &geo.VAO);
+    glBindVertexArray(geo.VAO);
+    glGenBuffers(1, &geo.VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, geo.VBO);
+    glBufferData(GL_ARRAY_BUFFER,
+        static_cast<GLsizeiptr>(vertexCount * stride),
+        data,
+        GL_STATIC_DRAW);
+    if (indexCount > 0) {
+        glGenBuffers(1, &geo.EBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geo.EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+            static_cast<GLsizeiptr>(indexCount * sizeof(unsigned int)),
+            indices,
+            GL_STATIC_DRAW);
+    }
+    setVertexPointers(packed, 0);
     glBindVertexArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    if (!indices.empty()) glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    _isSetup = true;
+    if (indexCount > 0) glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    geo.packed = packed;
+    geo.bytes = vertexCount * stride + indexCount * sizeof(unsigned int);
+    return geo;
+}
+
+void Mesh::setupMesh() {
+    if (_isSetup || vertices.empty()) return;
+    adoptGeometry(uploadGeometry(vertices, indices));
     computeAABB();
 }
 
-void Mesh::draw() const {
-    if (!_isSetup || VAO == 0) return;
-    if (textureID != 0) {
-        glEnable(GL_TEXTURE_2D);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, textureID);
+void Mesh::setupMeshFromStream(const void* gpuVertices, bool packed, const AABB& bounds) {
+    if (_isSetup || vertices.empty()) return;
+    // Un stream empaquetado no sirve si el driver no tiene los formatos: se convierte
+    if (!gpuVertices || (packed && !packedFormatsSupported())) {
+        setupMesh();
+        return;
+    }
+    adoptGeometry(uploadVertexData(gpuVertices, vertices.size(), packed, indices.data(), indices.size()));
+    localAABB = bounds;
+    _bvh.reset();
+    _normalsLength = -1.0;
+}
+
+void Mesh::setupMeshFromBlob(std::shared_ptr<const MeshBlob> blob, size_t subMesh) {
+    if (_isSetup || !blob) return;
+    const MeshBlob::SubMesh sm = blob->subMesh(subMesh);
+    if (sm.vertexCount == 0) return;
+    // Sin formatos empaquetados el stream no se puede subir tal cual: se rehacen
+    // los Vertex y se sube como un mesh normal
+    if (sm.packed && !packedFormatsSupported()) {
+        unpackVertices(sm.gpuVertices, sm.vertexCount, true, vertices);
+        indices.assign(sm.indices, sm.indices + sm.indexCount);
+        setupMesh();
+        localAABB = sm.bounds;
+        return;
+    }
+    _blob = std::move(blob);
+    _blobVertices = sm.gpuVertices;
+    _blobIndices = sm.indices;
+    _blobVertexCount = sm.vertexCount;
+    _blobIndexCount = sm.indexCount;
+    adoptGeometry(uploadVertexData(sm.gpuVertices, sm.vertexCount, sm.packed, sm.indices, sm.indexCount));
+    localAABB = sm.bounds;
+    _bvh.reset();
+    _normalsLength = -1.0;
+}
+
+const std::vector<Vertex>& Mesh::cpuVertices() const {
+    if (!_blob) return vertices;
+    if (_blobCpuVertices.empty() && _blobVertexCount > 0) {
+        unpackVertices(_blobVertices, _blobVertexCount, _packed, _blobCpuVertices);
+        s_cpuBytes += _blobCpuVertices.size() * sizeof(Vertex);
     }
+    return _blobCpuVertices;
+}
+
+void Mesh::adoptGeometry(const GpuGeometry& geo) {
+    VAO = geo.VAO;
+    VBO = geo.VBO;
+    EBO = geo.EBO;
+    _isSetup = true;
+    _packed = geo.packed;
+
+    // Un mesh de blob no tiene nada propio en RAM hasta que se piden sus Vertex
+    _gpuBytes = geo.bytes;
+    _cpuBytes = vertices.size() * sizeof(Vertex) + indices.size() * sizeof(unsigned int);
+    s_gpuBytes += _gpuBytes;
+    s_cpuBytes += _cpuBytes;
+    s_doubleLayoutBytes += getVertexCount() * kDoubleLayoutVertexBytes + getIndexCount() * sizeof(unsigned int);
+    ++(_packed ? s_packedMeshes : s_floatMeshes);
+}
+
+void Mesh::bindArenaBuffers(GLuint vbo, GLuint ebo, uint32_t baseVertex, uint32_t firstIndex) const {
     glBindVertexArray(VAO);
-    if (!indices.empty()) {
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    setVertexPointers(_packed, size_t(baseVertex) * sizeof(PackedVertex));
+    if (getIndexCount() > 0) glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    _arenaIndexOffset = size_t(firstIndex) * sizeof(unsigned int);
+
+    // La geometria ya esta copiada en el arena: los buffers propios sobran.
+    // El mesh es const para el renderer, pero el VAO y los buffers son suyos
+    Mesh& self = const_cast<Mesh&>(*this);
+    if (self.EBO) { glDeleteBuffers(1, &self.EBO); self.EBO = 0; }
+    if (self.VBO) { glDeleteBuffers(1, &self.VBO); self.VBO = 0; }
+}
+
+void Mesh::drawBound(int instances) const {
+    const size_t indexCount = getIndexCount();
+    if (instances > 1) {
+        if (indexCount > 0) {
+            glDrawElementsInstanced(GL_TRIANGLES,
+                static_cast<GLsizei>(indexCount),
+                GL_UNSIGNED_INT, reinterpret_cast<const void*>(_arenaIndexOffset), instances);
+        }
+        else {
+            glDrawArraysInstanced(GL_TRIANGLES, 0,
+                static_cast<GLsizei>(getVertexCount()), instances);
+        }
+        return;
+    }
+    if (indexCount > 0) {
         glDrawElements(GL_TRIANGLES,
-            static_cast<GLsizei>(indices.size()),
-            GL_UNSIGNED_INT, 0);
+            static_cast<GLsizei>(indexCount),
+            GL_UNSIGNED_INT, reinterpret_cast<const void*>(_arenaIndexOffset));
     }
     else {
         glDrawArrays(GL_TRIANGLES, 0,
-            static_cast<GLsizei>(vertices.size()));
-    }
-    glBindVertexArray(0);
-    if (textureID != 0) {
-        glBindTexture(GL_TEXTURE_2D, 0);
-        glDisable(GL_TEXTURE_2D);
+            static_cast<GLsizei>(getVertexCount()));
     }
-    if (showVertexNormals) drawVertexNormals();
-    if (showFaceNormals) drawFaceNormals();
 }
 
-void Mesh::drawVertexNormals() const {
-    glDisable(GL_LIGHTING);
-    glColor3f(0.0f, 1.0f, 0.0f);
-    glBegin(GL_LINES);
+void Mesh::drawNormals(const mat4& world) const {
+    if (!showVertexNormals && !showFaceNormals) return;
+    if (!_normalsVBO || _normalsLength != normalLength) buildNormalLines();
+
+    // Con las dos activas el rango es contiguo: un solo draw
+    GLint first = showVertexNormals ? 0 : _vertexNormalVerts;
+    GLsizei count = (showVertexNormals ? _vertexNormalVerts : 0) + (showFaceNormals ? _faceNormalVerts : 0);
+    DebugDraw::instance().lineBuffer(_normalsVBO, first, count, world);
+}
+
+void Mesh::buildNormalLines() const {
+    const std::vector<Vertex>& vertices = cpuVertices();
+    const unsigned int* indices = indexData();
+    const bool indexed = getIndexCount() > 0;
+    std::vector<DebugDraw::LineVertex> lines;
+    lines.reserve((vertices.size() + getTriangleCount()) * 2);
+
     for (const auto& v : vertices) {
-        vec3 start = v.position;
-        vec3 end = v.position + v.normal * normalLength;
-        glVertex3d(start.x, start.y, start.z);
-        glVertex3d(end.x, end.y, end.z);
+        lines.push_back(DebugDraw::makeVertex(v.position, Colors::Green));
+        lines.push_back(DebugDraw::makeVertex(v.position + vec3(v.normal) * normalLength, Colors::Green));
     }
-    glEnd();
-    glEnable(GL_LIGHTING);
-}
+    _vertexNormalVerts = static_cast<GLsizei>(lines.size());
 
-void Mesh::drawFaceNormals() const {
-    glDisable(GL_LIGHTING);
-    glColor3f(0.0f, 0.0f, 1.0f);
-    glBegin(GL_LINES);
     size_t triCount = getTriangleCount();
     for (size_t i = 0; i < triCount; ++i) {
         vec3 v0, v1, v2;
-        if (!indices.empty()) {
+        if (indexed) {
             v0 = vertices[indices[i * 3 + 0]].position;
             v1 = vertices[indices[i * 3 + 1]].position;
             v2 = vertices[indices[i * 3 + 2]].position;
@@ -101,16 +337,26 @@ void Mesh::drawFaceNormals() const {
             v1 = vertices[i * 3 + 1].position;
             v2 = vertices[i * 3 + 2].position;
         }
+        vec3 n = glm::cross(v1 - v0, v2 - v0);
+        double len = glm::length(n);
+        if (len <= 0.0) continue; // Triangulo degenerado: sin normal
         vec3 center = (v0 + v1 + v2) / 3.0;
-        vec3 edge1 = v1 - v0;
-        vec3 edge2 = v2 - v0;
-        vec3 normal = glm::normalize(glm::cross(edge1, edge2));
-        vec3 end = center + normal * normalLength;
-        glVertex3d(center.x, center.y, center.z);
-        glVertex3d(end.x, end.y, end.z);
+        lines.push_back(DebugDraw::makeVertex(center, Colors::Blue));
+        lines.push_back(DebugDraw::makeVertex(center + n * (normalLength / len), Colors::Blue));
     }
-    glEnd();
-    glEnable(GL_LIGHTING);
+    _faceNormalVerts = static_cast<GLsizei>(lines.size()) - _vertexNormalVerts;
+
+    if (!_normalsVBO) glGenBuffers(1, &_normalsVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, _normalsVBO);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(lines.size() * sizeof(DebugDraw::LineVertex)),
+        lines.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    _normalsLength = normalLength;
+}
+
+void Mesh::setTexture(std::shared_ptr<TextureResource> tex) {
+    textureID = tex ? tex->id : 0;
+    textureRef = std::move(tex);
 }
 
 unsigned int Mesh::getTextureID() const {
@@ -118,6 +364,23 @@ unsigned int Mesh::getTextureID() const {
 }
 
 void Mesh::cleanup() {
+    if (_inArena) MeshArena::instance().release(this);
+    if (_isSetup) {
+        s_gpuBytes -= _gpuBytes;
+        s_cpuBytes -= _cpuBytes + _blobCpuVertices.size() * sizeof(Vertex);
+        s_doubleLayoutBytes -= getVertexCount() * kDoubleLayoutVertexBytes + getIndexCount() * sizeof(unsigned int);
+        --(_packed ? s_packedMeshes : s_floatMeshes);
+        _gpuBytes = _cpuBytes = 0;
+        _isSetup = false;
+    }
+    // Suelta el mapeo del blob (se cierra con el ultimo mesh que lo usa)
+    _blob.reset();
+    _blobVertices = nullptr;
+    _blobIndices = nullptr;
+    _blobVertexCount = _blobIndexCount = 0;
+    std::vector<Vertex>().swap(_blobCpuVertices);
+    if (_normalsVBO) { glDeleteBuffers(1, &_normalsVBO); _normalsVBO = 0; }
+    _normalsLength = -1.0;
     if (EBO) { glDeleteBuffers(1, &EBO); EBO = 0; }
     if (VBO) { glDeleteBuffers(1, &VBO); VBO = 0; }
     if (VAO) { glDeleteVertexArrays(1, &VAO); VAO = 0; }
@@ -125,8 +388,22 @@ void Mesh::cleanup() {
 
 void Mesh::computeAABB() {
     localAABB = AABB();
+    _bvh.reset(); // Los vertices han cambiado: reconstruir en el proximo pick
+    _normalsLength = -1.0; // Y las lineas de normales en el proximo draw
 
     for (const auto& vertex : vertices) {
         localAABB.expand(vertex.position);
     }
-}
\ No newline at end of file
+}
+
+const MeshBVH& Mesh::getBVH() const {
+    if (!_bvh) {
+        _bvh = std::make_unique<MeshBVH>();
+        _bvh->build(*this);
+    }
+    return *_bvh;
+}
+
+bool Mesh::raycast(const Ray& localRay, MeshBVH::Hit& hit) const {
+    return getBVH().intersect(*this, localRay, hit);
+}
@@ -1,16 +1,59 @@
 #pragma once
 #include "types.h"
 #include "AABB.h"
+#include "MeshBVH.h"
 #include <vector>
 #include <string>
+#include <memory>
+#include <cstdint>
 #include <GL/glew.h>
 
+struct TextureResource;
+class MeshBlob;
+
+// Vertice en CPU (44 bytes). La posicion en double, que la usan el picking,
+// las AABB y los lotes estaticos; la normal solo sombrea y pinta lineas de debug
 struct Vertex {
     vec3       position;
-    vec3       normal;
+    glm::vec3  normal;
     glm::vec2  texCoord;
 };
 
+// Lo que ocupaba un vertice con el formato anterior (todo en double), para comparar
+static const size_t kDoubleLayoutVertexBytes = 3 * sizeof(double) + 3 * sizeof(double) + 2 * sizeof(float);
+
+// Vertice en GPU (20 bytes), generado al subir el mesh
+struct PackedVertex {
+    float    position[3];
+    uint32_t normal;   // GL_INT_2_10_10_10_REV, glm::packSnorm3x10_1x2
+    uint32_t texCoord; // Dos half float, glm::packHalf2x16
+};
+
+// Alternativa de 32 bytes: drivers sin formatos empaquetados o UV fuera del rango de half
+struct FloatVertex {
+    float position[3];
+    float normal[3];
+    float texCoord[2];
+};
+
+// Contadores globales de memoria de meshes, para el panel de Config
+struct MeshMemoryStats {
+    size_t cpuBytes = 0;          // Vertex + indices en RAM
+    size_t gpuBytes = 0;          // VBO + EBO realmente subidos
+    size_t doubleLayoutBytes = 0; // Lo que ocuparian los mismos VBO con el formato double anterior
+    size_t packedMeshes = 0;
+    size_t floatMeshes = 0;
+};
+
+// Buffers de GPU creados por Mesh::uploadGeometry
+struct GpuGeometry {
+    GLuint VAO = 0;
+    GLuint VBO = 0;
+    GLuint EBO = 0;
+    bool packed = false;
+    size_t bytes = 0;
+};
+
 class Mesh {
 public:
     std::vector<Vertex>         vertices;
@@ -21,6 +64,7 @@ public:
     GLuint VBO = 0;
     GLuint EBO = 0;
     GLuint textureID = 0;
+    std::shared_ptr<TextureResource> textureRef; // Si la textura viene del ResourceManager
 
     bool showVertexNormals = false;
     bool showFaceNormals = false;
@@ -32,21 +76,82 @@ public:
     Mesh(const std::vector<Vertex>& verts, const std::vector<unsigned int>& inds);
     ~Mesh();
     void setupMesh();
-    void draw() const;
+    // Como setupMesh, pero sube un stream ya en formato de GPU (convertido en un
+    // worker) en vez de convertir los Vertex. vertices/indices ya cargados
+    void setupMeshFromStream(const void* gpuVertices, bool packed, const AABB& bounds);
+    // Sub-mesh de un MeshBlob mapeado: stream de GPU e indices se suben desde el
+    // mapeo, que el mesh mantiene vivo; vertices/indices se quedan vacios
+    void setupMeshFromBlob(std::shared_ptr<const MeshBlob> blob, size_t subMesh);
+    // Solo la draw call: el VAO ya tiene que estar enlazado (RenderQueue).
+    // Con instances > 1 usa glDraw*Instanced
+    void drawBound(int instances = 1) const;
+    // Normales de debug como lineas en mundo, acumuladas en DebugDraw
+    void drawNormals(const mat4& world) const;
     void cleanup();
-    void setTexture(GLuint texID) { textureID = texID; }
+    void setTexture(GLuint texID) { textureID = texID; textureRef.reset(); }
+    void setTexture(std::shared_ptr<TextureResource> tex);
     unsigned int getTexture() const { return textureID; }
-    size_t getVertexCount() const { return vertices.size(); }
-    size_t getTriangleCount() const { return indices.empty() ? vertices.size() / 3 : indices.size() / 3; }
+    size_t getVertexCount() const { return _blob ? _blobVertexCount : vertices.size(); }
+    size_t getIndexCount() const { return _blob ? _blobIndexCount : indices.size(); }
+    size_t getTriangleCount() const { return getIndexCount() == 0 ? getVertexCount() / 3 : getIndexCount() / 3; }
+    // Geometria de CPU para picking, normales y lotes estaticos. En un mesh de
+    // blob los Vertex se rehacen del stream de GPU la primera vez que se piden
+    const std::vector<Vertex>& cpuVertices() const;
+    const unsigned int* indexData() const { return _blob ? _blobIndices : indices.data(); }
 
     void computeAABB();
 
+    // Crea VAO/VBO/EBO con el formato de GPU (PackedVertex o FloatVertex) y los
+    // punteros legacy y genericos 0/1/2. Tambien lo usan los lotes estaticos.
+    static GpuGeometry uploadGeometry(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
+    static GpuGeometry uploadVertexData(const void* data, size_t vertexCount, bool packed,
+        const unsigned int* indices, size_t indexCount);
+    static void packVertices(const std::vector<Vertex>& vertices, std::vector<PackedVertex>& out);
+    static void floatVertices(const std::vector<Vertex>& vertices, std::vector<FloatVertex>& out);
+    // Inversa de packVertices/floatVertices (posicion en float, normal y UV segun el formato)
+    static void unpackVertices(const void* data, size_t count, bool packed, std::vector<Vertex>& out);
+    // Las UV caben en half sin perder precision (si no, FloatVertex)
+    static bool fitsPackedFormat(const std::vector<Vertex>& vertices);
+    bool isPacked() const { return _packed; }
+
+    static MeshMemoryStats memoryStats();
+    size_t gpuBytes() const { return _gpuBytes; }
+
     AABB getWorldAABB(const mat4& worldMatrix) const {
         return localAABB.transform(worldMatrix);
     }
 
+    // BVH de triangulos para picking; se construye la primera vez que se pide
+    // y se descarta en computeAABB, junto con localAABB
+    const MeshBVH& getBVH() const;
+    // Rayo en espacio local; solo acepta hits mas cercanos que hit.t
+    bool raycast(const Ray& localRay, MeshBVH::Hit& hit) const;
+
 private:
     bool _isSetup = false;
-    void drawVertexNormals() const;
-    void drawFaceNormals() const;
+    bool _packed = false;
+    size_t _gpuBytes = 0;
+    size_t _cpuBytes = 0;
+    mutable std::unique_ptr<MeshBVH> _bvh;
+    // Mapeo del MeshBlob del que sale la geometria (setupMeshFromBlob)
+    std::shared_ptr<const MeshBlob> _blob;
+    const void* _blobVertices = nullptr;
+    const unsigned int* _blobIndices = nullptr;
+    size_t _blobVertexCount = 0;
+    size_t _blobIndexCount = 0;
+    mutable std::vector<Vertex> _blobCpuVertices; // Rehechos por cpuVertices()
+    mutable bool _inArena = false; // Lo gestiona MeshArena
+    // Con el mesh en el arena el VAO apunta a los buffers compartidos y los
+    // propios se borran; el draw empieza en este byte del EBO del arena
+    mutable size_t _arenaIndexOffset = 0;
+    friend class MeshArena;
+    void bindArenaBuffers(GLuint vbo, GLuint ebo, uint32_t baseVertex, uint32_t firstIndex) const;
+    void adoptGeometry(const GpuGeometry& geo);
+    // Normales de debug cacheadas en un VBO en espacio local: primero las de
+    // vertice y luego las de cara. Se rehacen si cambia normalLength o los vertices
+    mutable GLuint _normalsVBO = 0;
+    mutable GLsizei _vertexNormalVerts = 0;
+    mutable GLsizei _faceNormalVerts = 0;
+    mutable double _normalsLength = -1.0; // < 0: hay que reconstruir
+    void buildNormalLines() const;
 };
\ No newline at end of file
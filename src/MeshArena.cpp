@@ -0,0 +1,187 @@
+#include "MeshArena.h"
+#include "Mesh.h"
+#include "Logger.h"
+#include <algorithm>
+#include <string>
+
+uint32_t RangeAllocator::allocate(uint32_t count) {
+    for (auto it = free_.begin(); it != free_.end(); ++it) {
+        if (it->second < count) continue;
+        const uint32_t offset = it->first;
+        const uint32_t rest = it->second - count;
+        free_.erase(it);
+        if (rest > 0) free_[offset + count] = rest;
+        freeCount_ -= count;
+        return offset;
+    }
+    const uint32_t offset = end_;
+    end_ += count;
+    return offset;
+}
+
+void RangeAllocator::release(uint32_t offset, uint32_t count) {
+    if (count == 0) return;
+    freeCount_ += count;
+    auto next = free_.lower_bound(offset);
+    // Fusionar con el hueco anterior si acaba justo aqui
+    if (next != free_.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            count += prev->second;
+            free_.erase(prev);
+        }
+    }
+    if (next != free_.end() && offset + count == next->first) {
+        count += next->second;
+        free_.erase(next);
+    }
+    // Un hueco al final se devuelve al puntero de crecimiento
+    if (offset + count == end_) {
+        end_ = offset;
+        freeCount_ -= count;
+        return;
+    }
+    free_[offset] = count;
+}
+
+void RangeAllocator::reset() {
+    free_.clear();
+    end_ = 0;
+    freeCount_ = 0;
+}
+
+MeshArena& MeshArena::instance() {
+    static MeshArena g;
+    return g;
+}
+
+bool MeshArena::supported() {
+    return GLEW_VERSION_4_3 || (GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance && GLEW_VERSION_3_3);
+}
+
+GLuint MeshArena::growBuffer(GLuint old, size_t oldBytes, size_t newBytes) {
+    GLuint buffer = 0;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(newBytes), nullptr, GL_STATIC_DRAW);
+    if (old && oldBytes > 0) {
+        glBindBuffer(GL_COPY_READ_BUFFER, old);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(oldBytes));
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    if (old) glDeleteBuffers(1, &old);
+    return buffer;
+}
+
+void MeshArena::ensureCapacity(uint32_t vertices, uint32_t indices) {
+    bool changed = false;
+    if (vertices > vertexCapacity_) {
+        const uint32_t cap = std::max<uint32_t>(vertices, std::max<uint32_t>(vertexCapacity_ * 2, 1u << 16));
+        vbo_ = growBuffer(vbo_, size_t(vertexCapacity_) * sizeof(PackedVertex), size_t(cap) * sizeof(PackedVertex));
+        vertexCapacity_ = cap;
+        changed = true;
+    }
+    if (indices > indexCapacity_) {
+        const uint32_t cap = std::max<uint32_t>(indices, std::max<uint32_t>(indexCapacity_ * 2, 1u << 18));
+        ebo_ = growBuffer(ebo_, size_t(indexCapacity_) * sizeof(unsigned int), size_t(cap) * sizeof(unsigned int));
+        indexCapacity_ = cap;
+        changed = true;
+    }
+    // Buffers nuevos: el VAO del arena y los de los meshes apuntaban a los viejos
+    if (!changed) return;
+    setupVAO();
+    for (const auto& entry : allocations_)
+        entry.first->bindArenaBuffers(vbo_, ebo_, entry.second.baseVertex, entry.second.firstIndex);
+}
+
+void MeshArena::setupVAO() {
+    if (!vao_) glGenVertexArrays(1, &vao_);
+    glBindVertexArray(vao_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(PackedVertex),
+        reinterpret_cast<const void*>(offsetof(PackedVertex, position)));
+    glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(PackedVertex),
+        reinterpret_cast<const void*>(offsetof(PackedVertex, normal)));
+    glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex),
+        reinterpret_cast<const void*>(offsetof(PackedVertex, texCoord)));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+const MeshArena::Allocation* MeshArena::acquire(const Mesh& mesh) {
+    auto it = allocations_.find(&mesh);
+    if (it != allocations_.end()) return &it->second;
+    if (!mesh.isPacked() || !mesh.VBO || mesh.getVertexCount() == 0) return nullptr;
+
+    Allocation a;
+    a.vertexCount = (uint32_t)mesh.getVertexCount();
+    a.indexCount = (uint32_t)(mesh.getIndexCount() == 0 ? mesh.getVertexCount() : mesh.getIndexCount());
+    a.baseVertex = vertexRanges_.allocate(a.vertexCount);
+    a.firstIndex = indexRanges_.allocate(a.indexCount);
+    ensureCapacity(vertexRanges_.end(), indexRanges_.end());
+
+    // Copia en GPU desde los buffers del mesh, que ya estan en PackedVertex.
+    // Los indices quedan relativos al mesh: baseVertex los desplaza en el draw
+    glBindBuffer(GL_COPY_WRITE_BUFFER, vbo_);
+    glBindBuffer(GL_COPY_READ_BUFFER, mesh.VBO);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0,
+        GLintptr(a.baseVertex) * sizeof(PackedVertex), GLsizeiptr(a.vertexCount) * sizeof(PackedVertex));
+    glBindBuffer(GL_COPY_WRITE_BUFFER, ebo_);
+    if (mesh.EBO) {
+        glBindBuffer(GL_COPY_READ_BUFFER, mesh.EBO);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0,
+            GLintptr(a.firstIndex) * sizeof(unsigned int), GLsizeiptr(a.indexCount) * sizeof(unsigned int));
+    }
+    else {
+        // Sin EBO propio: indices secuenciales para el comando indirect
+        std::vector<unsigned int> sequential(a.indexCount);
+        for (size_t i = 0; i < sequential.size(); ++i) sequential[i] = (unsigned int)i;
+        glBufferSubData(GL_COPY_WRITE_BUFFER, GLintptr(a.firstIndex) * sizeof(unsigned int),
+            GLsizeiptr(sequential.size() * sizeof(unsigned int)), sequential.data());
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    // El VAO del mesh pasa a leer del arena y sus buffers se liberan: la
+    // geometria no queda dos veces en VRAM
+    mesh.bindArenaBuffers(vbo_, ebo_, a.baseVertex, a.firstIndex);
+    mesh._inArena = true;
+    return &(allocations_[&mesh] = a);
+}
+
+void MeshArena::release(const Mesh* mesh) {
+    auto it = allocations_.find(mesh);
+    if (it == allocations_.end()) return;
+    vertexRanges_.release(it->second.baseVertex, it->second.vertexCount);
+    indexRanges_.release(it->second.firstIndex, it->second.indexCount);
+    mesh->_inArena = false;
+    allocations_.erase(it);
+}
+
+void MeshArena::shutdown() {
+    // Solo al cerrar: los meshes que quedasen en el arena se quedan sin geometria
+    for (auto& entry : allocations_) entry.first->_inArena = false;
+    allocations_.clear();
+    vertexRanges_.reset();
+    indexRanges_.reset();
+    if (vao_) { glDeleteVertexArrays(1, &vao_); vao_ = 0; }
+    if (vbo_) { glDeleteBuffers(1, &vbo_); vbo_ = 0; }
+    if (ebo_) { glDeleteBuffers(1, &ebo_); ebo_ = 0; }
+    vertexCapacity_ = indexCapacity_ = 0;
+}
+
+size_t MeshArena::capacityBytes() const {
+    return size_t(vertexCapacity_) * sizeof(PackedVertex) + size_t(indexCapacity_) * sizeof(unsigned int);
+}
+
+size_t MeshArena::usedBytes() const {
+    const size_t v = vertexRanges_.end() - vertexRanges_.freeCount();
+    const size_t i = indexRanges_.end() - indexRanges_.freeCount();
+    return v * sizeof(PackedVertex) + i * sizeof(unsigned int);
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include <GL/glew.h>
+
+class Mesh;
+
+// Rangos libres dentro de un buffer (en elementos, no bytes). Primer hueco que
+// quepa; al liberar se fusiona con los vecinos. Si no hay hueco crece por el final.
+class RangeAllocator {
+public:
+    uint32_t allocate(uint32_t count);
+    void release(uint32_t offset, uint32_t count);
+    void reset();
+    uint32_t end() const { return end_; }
+    uint32_t freeCount() const { return freeCount_; }
+
+private:
+    std::map<uint32_t, uint32_t> free_; // offset -> tamaño
+    uint32_t end_ = 0;
+    uint32_t freeCount_ = 0;
+};
+
+// Vertices e indices de todos los meshes empaquetados en un VBO/EBO compartidos
+// con un unico VAO, para poder pintar meshes distintos en la misma
+// glMultiDrawElementsIndirect. Los meshes entran la primera vez que se piden y
+// salen al destruirse (Mesh::cleanup). Al entrar se copian en GPU desde su
+// VBO/EBO, que se liberan: su VAO pasa a apuntar al rango del arena. Solo
+// formato PackedVertex: los meshes que van en FloatVertex siguen en sus buffers.
+class MeshArena {
+public:
+    struct Allocation {
+        uint32_t baseVertex = 0;
+        uint32_t vertexCount = 0;
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+    };
+
+    static MeshArena& instance();
+    // Necesita GL 4.3 o ARB_multi_draw_indirect + ARB_base_instance
+    static bool supported();
+
+    // Copia el mesh si aun no estaba; nullptr si no puede entrar
+    const Allocation* acquire(const Mesh& mesh);
+    void release(const Mesh* mesh);
+    void shutdown();
+
+    // Atributos 0/1/2 y EBO del arena; los de instancia los pone el renderer
+    GLuint vao() const { return vao_; }
+    size_t meshCount() const { return allocations_.size(); }
+    size_t capacityBytes() const;
+    size_t usedBytes() const;
+
+private:
+    MeshArena() = default;
+    MeshArena(const MeshArena&) = delete;
+    MeshArena& operator=(const MeshArena&) = delete;
+
+    void ensureCapacity(uint32_t vertices, uint32_t indices);
+    // Buffer nuevo con el contenido del viejo (glCopyBufferSubData); borra el viejo
+    static GLuint growBuffer(GLuint old, size_t oldBytes, size_t newBytes);
+    void setupVAO();
+
+    std::unordered_map<const Mesh*, Allocation> allocations_;
+    RangeAllocator vertexRanges_;
+    RangeAllocator indexRanges_;
+    GLuint vao_ = 0;
+    GLuint vbo_ = 0;
+    GLuint ebo_ = 0;
+    uint32_t vertexCapacity_ = 0;
+    uint32_t indexCapacity_ = 0;
+};
@@ -0,0 +1,142 @@
+#include "MeshBVH.h"
+#include "Mesh.h"
+#include <algorithm>
+
+static void triangleVertices(const Mesh& mesh, uint32_t tri, vec3& a, vec3& b, vec3& c) {
+    const std::vector<Vertex>& vertices = mesh.cpuVertices();
+    if (mesh.getIndexCount() > 0) {
+        const unsigned int* indices = mesh.indexData();
+        a = vertices[indices[tri * 3 + 0]].position;
+        b = vertices[indices[tri * 3 + 1]].position;
+        c = vertices[indices[tri * 3 + 2]].position;
+    }
+    else {
+        a = vertices[tri * 3 + 0].position;
+        b = vertices[tri * 3 + 1].position;
+        c = vertices[tri * 3 + 2].position;
+    }
+}
+
+void MeshBVH::build(const Mesh& mesh) {
+    nodes.clear();
+    triIndices.clear();
+    const uint32_t triCount = (uint32_t)mesh.getTriangleCount();
+    if (triCount == 0) return;
+
+    // Caja y centroide de cada triangulo, calculados una sola vez
+    std::vector<AABB> triBoxes(triCount);
+    std::vector<vec3> centroids(triCount);
+    triIndices.resize(triCount);
+    for (uint32_t i = 0; i < triCount; ++i) {
+        vec3 a, b, c;
+        triangleVertices(mesh, i, a, b, c);
+        triBoxes[i].expand(a);
+        triBoxes[i].expand(b);
+        triBoxes[i].expand(c);
+        centroids[i] = (a + b + c) / 3.0;
+        triIndices[i] = i;
+    }
+    nodes.reserve(2 * (triCount / kMaxLeafTriangles + 1));
+
+    // Construccion iterativa: {nodo, primer triangulo, numero de triangulos}
+    struct Task { uint32_t node, first, count, depth; };
+    std::vector<Task> stack;
+    nodes.emplace_back();
+    stack.push_back({ 0, 0, triCount, 0 });
+
+    while (!stack.empty()) {
+        Task task = stack.back();
+        stack.pop_back();
+
+        AABB box, centroidBox;
+        for (uint32_t i = task.first; i < task.first + task.count; ++i) {
+            box.merge(triBoxes[triIndices[i]]);
+            centroidBox.expand(centroids[triIndices[i]]);
+        }
+        nodes[task.node].box = box;
+
+        if (task.count <= kMaxLeafTriangles) {
+            nodes[task.node].first = task.first;
+            nodes[task.node].count = task.count;
+            continue;
+        }
+
+        // Partir por el eje mas largo de los centroides, en el punto medio; si todo
+        // cae a un lado, o el arbol se hace muy profundo, por la mediana
+        vec3 extent = centroidBox.size();
+        int axis = 0;
+        if (extent.y > extent[axis]) axis = 1;
+        if (extent.z > extent[axis]) axis = 2;
+        double mid = centroidBox.center()[axis];
+
+        uint32_t* begin = triIndices.data() + task.first;
+        uint32_t* end = begin + task.count;
+        uint32_t* split = std::partition(begin, end, [&](uint32_t t) { return centroids[t][axis] < mid; });
+        if (split == begin || split == end || task.depth >= kMaxMidpointDepth) {
+            split = begin + task.count / 2;
+            std::nth_element(begin, split, end, [&](uint32_t a, uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+        }
+        uint32_t leftCount = (uint32_t)(split - begin);
+
+        uint32_t left = (uint32_t)nodes.size();
+        nodes.emplace_back();
+        nodes.emplace_back();
+        nodes[task.node].first = left;
+        nodes[task.node].count = 0;
+        stack.push_back({ left + 1, task.first + leftCount, task.count - leftCount, task.depth + 1 });
+        stack.push_back({ left, task.first, leftCount, task.depth + 1 });
+    }
+}
+
+bool MeshBVH::intersect(const Mesh& mesh, const Ray& ray, Hit& hit) const {
+    if (nodes.empty()) return false;
+    double t;
+    if (!ray.intersectsAABB(nodes[0].box, t) || t >= hit.t) return false;
+
+    // Con la mediana a partir de kMaxMidpointDepth la profundidad queda acotada
+    struct Entry { uint32_t node; double t; };
+    Entry stack[kMaxStack];
+    int top = 0;
+    stack[top++] = { 0, t };
+
+    bool found = false;
+    while (top > 0) {
+        Entry e = stack[--top];
+        if (e.t >= hit.t) continue; // Un hit posterior ya queda antes que este nodo
+        const Node& node = nodes[e.node];
+
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                vec3 a, b, c;
+                double u, v;
+                triangleVertices(mesh, triIndices[i], a, b, c);
+                if (ray.intersectsTriangle(a, b, c, t, u, v) && t < hit.t) {
+                    hit.t = t;
+                    hit.triangle = triIndices[i];
+                    hit.u = u;
+                    hit.v = v;
+                    found = true;
+                }
+            }
+            continue;
+        }
+
+        // Apilar primero el hijo lejano, para visitar antes el cercano y podar con su hit
+        double tLeft, tRight;
+        bool hitLeft = ray.intersectsAABB(nodes[node.first].box, tLeft) && tLeft < hit.t;
+        bool hitRight = ray.intersectsAABB(nodes[node.first + 1].box, tRight) && tRight < hit.t;
+        if (hitLeft && hitRight) {
+            if (tLeft <= tRight) {
+                stack[top++] = { node.first + 1, tRight };
+                stack[top++] = { node.first, tLeft };
+            }
+            else {
+                stack[top++] = { node.first, tLeft };
+                stack[top++] = { node.first + 1, tRight };
+            }
+        }
+        else if (hitLeft) stack[top++] = { node.first, tLeft };
+        else if (hitRight) stack[top++] = { node.first + 1, tRight };
+    }
+    return found;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "types.h"
+#include "AABB.h"
+#include <vector>
+#include <cstdint>
+
+class Mesh;
+
+// BVH sobre los triangulos de un Mesh, en espacio local. Los nodos estan en un
+// array plano y los dos hijos de un nodo interno son contiguos.
+class MeshBVH {
+public:
+    static constexpr uint32_t kNoTriangle = 0xFFFFFFFFu;
+
+    struct Hit {
+        double t = std::numeric_limits<double>::max();
+        uint32_t triangle = kNoTriangle; // Indice del triangulo en el Mesh
+        double u = 0.0, v = 0.0;         // Baricentricas
+    };
+
+    void build(const Mesh& mesh);
+    // El rayo puede no estar normalizado: t se mide en unidades de su direccion.
+    // Solo acepta hits con t < hit.t, asi se puede encadenar entre meshes.
+    bool intersect(const Mesh& mesh, const Ray& ray, Hit& hit) const;
+
+    bool empty() const { return nodes.empty(); }
+    size_t nodeCount() const { return nodes.size(); }
+
+private:
+    struct Node {
+        AABB box;
+        uint32_t first = 0; // Hoja: primer triangulo en triIndices. Interno: hijo izquierdo (el derecho es first + 1)
+        uint32_t count = 0; // Triangulos de la hoja; 0 = nodo interno
+    };
+
+    static constexpr uint32_t kMaxLeafTriangles = 4;
+    static constexpr uint32_t kMaxMidpointDepth = 32;
+    static constexpr int kMaxStack = 128;
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> triIndices;
+};
@@ -0,0 +1,196 @@
+#include "MeshBlob.h"
+#include "Logger.h"
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+static const uint64_t kStreamAlign = 16;
+
+static uint64_t alignUp(uint64_t v) {
+    return (v + kStreamAlign - 1) & ~(kStreamAlign - 1);
+}
+
+bool MeshBlob::write(const std::string& path, uint64_t importKey, const std::vector<ImportedMesh>& meshes) {
+    Header h{};
+    h.magic = kMagic;
+    h.version = kVersion;
+    h.subMeshCount = (uint32_t)meshes.size();
+    h.importKey = importKey;
+
+    // Layout: primero las tablas, despues los streams de cada sub-mesh
+    std::vector<SubMeshEntry> table(meshes.size());
+    std::string names;
+    uint64_t offset = sizeof(Header) + meshes.size() * sizeof(SubMeshEntry);
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        table[i].textureOffset = (uint32_t)names.size();
+        table[i].textureLength = (uint32_t)meshes[i].texture.size();
+        names += meshes[i].texture;
+    }
+    h.stringTableOffset = offset;
+    h.stringTableSize = names.size();
+    offset += names.size();
+
+    AABB total;
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        const ImportedMesh& m = meshes[i];
+        SubMeshEntry& e = table[i];
+        e.vertexCount = (uint32_t)m.vertices.size();
+        e.indexCount = (uint32_t)m.indices.size();
+        e.packed = Mesh::fitsPackedFormat(m.vertices) ? 1u : 0u;
+        const size_t stride = e.packed ? sizeof(PackedVertex) : sizeof(FloatVertex);
+        offset = alignUp(offset);
+        e.gpuOffset = offset;
+        offset += m.vertices.size() * stride;
+        offset = alignUp(offset);
+        e.indexOffset = offset;
+        offset += m.indices.size() * sizeof(uint32_t);
+
+        AABB box;
+        for (const Vertex& v : m.vertices) box.expand(v.position);
+        total.merge(box);
+        for (int c = 0; c < 3; ++c) {
+            e.boundsMin[c] = box.min[c];
+            e.boundsMax[c] = box.max[c];
+        }
+    }
+    for (int c = 0; c < 3; ++c) {
+        h.boundsMin[c] = total.min[c];
+        h.boundsMax[c] = total.max[c];
+    }
+    h.fileSize = offset;
+
+    std::vector<uint8_t> buffer((size_t)offset, 0);
+    std::memcpy(buffer.data(), &h, sizeof(Header));
+    if (!table.empty()) std::memcpy(buffer.data() + sizeof(Header), table.data(), table.size() * sizeof(SubMeshEntry));
+    if (!names.empty()) std::memcpy(buffer.data() + h.stringTableOffset, names.data(), names.size());
+
+    std::vector<PackedVertex> packed;
+    std::vector<FloatVertex> floats;
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        const ImportedMesh& m = meshes[i];
+        const SubMeshEntry& e = table[i];
+        if (e.packed) {
+            Mesh::packVertices(m.vertices, packed);
+            if (!packed.empty()) std::memcpy(buffer.data() + e.gpuOffset, packed.data(), packed.size() * sizeof(PackedVertex));
+        }
+        else {
+            Mesh::floatVertices(m.vertices, floats);
+            if (!floats.empty()) std::memcpy(buffer.data() + e.gpuOffset, floats.data(), floats.size() * sizeof(FloatVertex));
+        }
+        if (!m.indices.empty()) std::memcpy(buffer.data() + e.indexOffset, m.indices.data(), m.indices.size() * sizeof(uint32_t));
+    }
+
+    // Se escribe a un temporal y se renombra: un blob a medias nunca queda con el
+    // nombre bueno. El temporal es por hilo, que la importacion corre en los workers.
+    // Sin excepciones de filesystem: el temporal se borra en cualquier fallo
+    std::error_code ec;
+    fs::create_directories(fs::path(path).parent_path(), ec);
+    const std::string suffix = std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    const std::string tmp = path + ".tmp" + suffix;
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (out) {
+            out.write(reinterpret_cast<const char*>(buffer.data()), (std::streamsize)buffer.size());
+            out.close();
+        }
+        if (!out) {
+            LOG_ERROR("Failed to write mesh blob: " + tmp);
+            fs::remove(tmp, ec);
+            return false;
+        }
+    }
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        // En Windows no se puede sobrescribir un blob que sigue mapeado, pero
+        // si apartarlo (MappedFile abre con FILE_SHARE_DELETE). El borrado se
+        // completa cuando se cierra el ultimo mapeo
+        const std::string old = path + ".old" + suffix;
+        std::error_code ignored;
+        fs::rename(path, old, ec);
+        if (!ec) {
+            fs::rename(tmp, path, ec);
+            if (ec) fs::rename(old, path, ignored); // Se deja el blob anterior
+            else fs::remove(old, ignored);
+        }
+        if (ec) {
+            LOG_ERROR("Failed to replace mesh blob " + path + ": " + ec.message());
+            fs::remove(tmp, ignored);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MeshBlob::open(const std::string& path) {
+    close();
+    if (!file_.open(path)) return false;
+    if (file_.size() < sizeof(Header)) {
+        close();
+        return false;
+    }
+    const Header* h = reinterpret_cast<const Header*>(file_.data());
+    if (h->magic != kMagic || h->version != kVersion || h->fileSize != file_.size()) {
+        close();
+        return false;
+    }
+    header_ = h;
+    // Tablas y streams dentro del fichero; un blob truncado o corrupto se reimporta
+    bool ok = inRange(sizeof(Header), (uint64_t)h->subMeshCount * sizeof(SubMeshEntry))
+        && inRange(h->stringTableOffset, h->stringTableSize);
+    for (uint32_t i = 0; ok && i < h->subMeshCount; ++i) {
+        const SubMeshEntry& e = entries()[i];
+        const size_t stride = e.packed ? sizeof(PackedVertex) : sizeof(FloatVertex);
+        ok = inRange(e.gpuOffset, (uint64_t)e.vertexCount * stride)
+            && inRange(e.indexOffset, (uint64_t)e.indexCount * sizeof(uint32_t))
+            && (uint64_t)e.textureOffset + e.textureLength <= h->stringTableSize
+            && e.gpuOffset % kStreamAlign == 0 && e.indexOffset % kStreamAlign == 0;
+    }
+    if (!ok) {
+        LOG_WARN("Corrupt mesh blob, reimporting: " + path);
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MeshBlob::close() {
+    header_ = nullptr;
+    file_.close();
+}
+
+bool MeshBlob::inRange(uint64_t offset, uint64_t bytes) const {
+    return offset <= file_.size() && bytes <= file_.size() - offset;
+}
+
+const MeshBlob::SubMeshEntry* MeshBlob::entries() const {
+    return reinterpret_cast<const SubMeshEntry*>(file_.data() + sizeof(Header));
+}
+
+size_t MeshBlob::subMeshCount() const {
+    return header_ ? header_->subMeshCount : 0;
+}
+
+MeshBlob::SubMesh MeshBlob::subMesh(size_t i) const {
+    SubMesh s;
+    if (!header_ || i >= header_->subMeshCount) return s;
+    const SubMeshEntry& e = entries()[i];
+    const uint8_t* base = file_.data();
+    s.gpuVertices = base + e.gpuOffset;
+    s.indices = reinterpret_cast<const uint32_t*>(base + e.indexOffset);
+    s.vertexCount = e.vertexCount;
+    s.indexCount = e.indexCount;
+    s.packed = e.packed != 0;
+    s.bounds = AABB(vec3(e.boundsMin[0], e.boundsMin[1], e.boundsMin[2]),
+                    vec3(e.boundsMax[0], e.boundsMax[1], e.boundsMax[2]));
+    s.texture.assign(reinterpret_cast<const char*>(base + header_->stringTableOffset + e.textureOffset), e.textureLength);
+    return s;
+}
+
+AABB MeshBlob::bounds() const {
+    if (!header_) return AABB();
+    return AABB(vec3(header_->boundsMin[0], header_->boundsMin[1], header_->boundsMin[2]),
+                vec3(header_->boundsMax[0], header_->boundsMax[1], header_->boundsMax[2]));
+}
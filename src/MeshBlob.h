@@ -0,0 +1,85 @@
+#pragma once
+#include "Mesh.h"
+#include "AABB.h"
+#include "MappedFile.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Sub-mesh de un modelo ya importado (Assimp + ajustes del .meta), sin GL
+struct ImportedMesh {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    std::string texture; // Nombre de la textura difusa tal como viene en el material
+};
+
+// Modelo importado en Library/<guid>, para cargarlo sin Assimp:
+//
+//   Header | tabla de SubMeshEntry | tabla de nombres | streams alineados a 16
+//
+// Por sub-mesh hay dos streams: los vertices ya en formato de GPU (PackedVertex
+// o FloatVertex) y los indices uint32. El Mesh se queda con el mapeo: sube los
+// dos a GL sin copiarlos y rehace los Vertex de CPU del stream de GPU solo si
+// se los piden (Mesh::setupMeshFromBlob).
+// La cabecera guarda la clave de importacion (AssetDatabase::importKey) con la
+// que se genero. El formato depende del endianness de la maquina: es una cache
+// local, si no cuadra se reimporta.
+class MeshBlob {
+public:
+    static const uint32_t kMagic = 0x48534D4D; // "MMSH"
+    static const uint32_t kVersion = 3;
+
+    struct SubMesh {
+        const void* gpuVertices = nullptr;
+        const uint32_t* indices = nullptr;
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+        bool packed = false;
+        AABB bounds;
+        std::string texture;
+    };
+
+    static bool write(const std::string& path, uint64_t importKey, const std::vector<ImportedMesh>& meshes);
+
+    // Mapea el fichero y valida cabecera y tablas
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return header_ != nullptr; }
+    uint64_t importKey() const { return header_ ? header_->importKey : 0; }
+
+    size_t subMeshCount() const;
+    SubMesh subMesh(size_t i) const;
+    AABB bounds() const;
+
+private:
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t reserved;
+        uint32_t subMeshCount;
+        uint64_t importKey;    // Fuente + ajustes + version del procesador
+        uint64_t fileSize;
+        uint64_t stringTableOffset;
+        uint64_t stringTableSize;
+        double boundsMin[3];
+        double boundsMax[3];
+    };
+    struct SubMeshEntry {
+        uint64_t gpuOffset;
+        uint64_t indexOffset;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t packed;       // 1: PackedVertex, 0: FloatVertex
+        uint32_t textureOffset; // En la tabla de nombres
+        uint32_t textureLength;
+        uint32_t reserved;
+        double boundsMin[3];
+        double boundsMax[3];
+    };
+
+    const SubMeshEntry* entries() const;
+    bool inRange(uint64_t offset, uint64_t bytes) const;
+
+    MappedFile file_;
+    const Header* header_ = nullptr;
+};
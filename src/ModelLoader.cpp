@@ -2,6 +2,10 @@
 #include "TextureLoader.h"
 #include "AssetMeta.h"
 #include "Mesh.h"
+#include "MeshBlob.h"
+#include "AssetDatabase.h"
+#include "ResourceManager.h"
+#include "Logger.h"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -13,6 +17,8 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 using std::string;
 using std::vector;
@@ -27,31 +33,47 @@ namespace {
         std::filesystem::path fp(p);
         return fp.has_parent_path() ? fp.parent_path().string() : std::string(".");
     }
-    static void AssignDiffuseTextureIfAny(const aiMaterial* mat,
-        const std::string& modelPath,
-        const shared_ptr<Mesh>& mesh) {
-        if (!mat || !mesh) return;
-        aiString tex;
-        if (mat->GetTexture(aiTextureType_DIFFUSE, 0, &tex) == AI_SUCCESS) {
-            std::filesystem::path full = std::filesystem::path(DirName(modelPath)) / tex.C_Str();
-            EnsureDevILInited();
-            if (unsigned int t = LoadTexture2D(full.string())) {
-                mesh->setTexture(t);
-                return;
-            }
-            if (unsigned int t2 = LoadTexture2D(tex.C_Str())) {
-                mesh->setTexture(t2);
-            }
+    // Una vez por nombre de textura del material: junto al modelo o, si no, la
+    // ruta tal cual. Se decodifica aunque el ResourceManager ya la tenga (desde el
+    // worker no se puede consultar); en ese caso al subir se descartan los pixeles
+    static void DecodeDiffuseTextures(const std::string& modelPath, std::vector<ParsedSubMesh>& subs) {
+        std::unordered_set<std::string> seen;
+        for (ParsedSubMesh& sub : subs) {
+            if (sub.texture.empty() || !seen.insert(sub.texture).second) continue;
+            auto decoded = std::make_unique<DecodedTexture>();
+            std::filesystem::path full = std::filesystem::path(DirName(modelPath)) / sub.texture;
+            if (DecodeTexture2D(full.string(), *decoded) || DecodeTexture2D(sub.texture, *decoded))
+                sub.decodedTexture = std::move(decoded);
+        }
+    }
+
+    // textureCache: texturas ya pedidas para este modelo, por nombre en el material
+    // (tambien las que fallan, para no reintentarlas). Los sub-meshes comparten una
+    // sola referencia del ResourceManager, y la textura GL con cualquier otro modelo.
+    static void AssignDiffuseTextureIfAny(ParsedSubMesh& sub,
+        const shared_ptr<Mesh>& mesh,
+        ModelLoader::TextureCache& textureCache) {
+        if (sub.texture.empty() || !mesh) return;
+        auto cached = textureCache.find(sub.texture);
+        if (cached != textureCache.end()) {
+            if (cached->second) mesh->setTexture(cached->second);
+            return;
         }
+        // Sin imagen decodificada es que no se encontro o no se pudo leer
+        shared_ptr<TextureResource> t;
+        if (sub.decodedTexture) t = ResourceManager::instance().acquireTexture(*sub.decodedTexture);
+        sub.decodedTexture.reset();
+        textureCache[sub.texture] = t;
+        if (t) mesh->setTexture(t);
     }
 
 }
 
-std::shared_ptr<Mesh> ModelLoader::processMesh(void* meshPtr, const void* scenePtr) {
+void ModelLoader::processMesh(void* meshPtr, const void* scenePtr, ImportedMesh& out) {
     aiMesh* mesh = static_cast<aiMesh*>(meshPtr);
-    if (!mesh) return nullptr;
-    std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices;
+    const aiScene* scene = static_cast<const aiScene*>(scenePtr);
+    std::vector<Vertex>& vertices = out.vertices;
+    std::vector<unsigned int>& indices = out.indices;
     vertices.reserve(mesh->mNumVertices);
     for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
         Vertex v{};
@@ -64,7 +86,7 @@ std::shared_ptr<Mesh> ModelLoader::processMesh(void* meshPtr, const void* sceneP
             v.normal.z = mesh->mNormals[i].z;
         }
         else {
-            v.normal = vec3(0.0, 0.0, 1.0);
+            v.normal = glm::vec3(0.0f, 0.0f, 1.0f);
         }
         if (mesh->mTextureCoords[0]) {
             v.texCoord.x = mesh->mTextureCoords[0][i].x;
@@ -81,15 +103,15 @@ std::shared_ptr<Mesh> ModelLoader::processMesh(void* meshPtr, const void* sceneP
             indices.push_back(face.mIndices[j]);
         }
     }
-    auto result = std::make_shared<Mesh>(vertices, indices);
-    result->setupMesh();
-    return result;
+    if (scene && mesh->mMaterialIndex < scene->mNumMaterials) {
+        aiString tex;
+        if (scene->mMaterials[mesh->mMaterialIndex]->GetTexture(aiTextureType_DIFFUSE, 0, &tex) == AI_SUCCESS)
+            out.texture = tex.C_Str();
+    }
 }
 
-std::vector<std::shared_ptr<Mesh>> ModelLoader::loadModel(const std::string& path) {
-    std::vector<std::shared_ptr<Mesh>> meshes;
-    AssetMeta meta;
-    bool hasMeta = AssetMeta::loadFromFile(path + ".meta", meta);
+bool ModelLoader::importModel(const std::string& path, const AssetMeta* meta, std::vector<ImportedMesh>& out) {
+    out.clear();
     Assimp::Importer importer;
     
     const aiScene* scene = importer.ReadFile(
@@ -107,46 +129,146 @@ std::vector<std::shared_ptr<Mesh>> ModelLoader::loadModel(const std::string& pat
     if (!scene || !scene->mRootNode || (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) != 0) {
         std::cerr << "Assimp error while loading \"" << path << "\": "
             << importer.GetErrorString() << std::endl;
-        return meshes;
+        return false;
     }
-    meshes.reserve(scene->mNumMeshes);
+
+    glm::dmat4 axis = glm::dmat4(1.0);
+    if (meta) {
+        if (meta->axisUp == "Z") {
+            axis = glm::rotate(axis, glm::radians(90.0), glm::dvec3(1,0,0));
+        }
+        if (meta->axisForward == "+Z") {
+            axis = axis * glm::dmat4(1.0);
+        } else if (meta->axisForward == "-Z") {
+            axis = glm::rotate(axis, glm::radians(180.0), glm::dvec3(0,1,0));
+        } else if (meta->axisForward == "+X") {
+            axis = glm::rotate(axis, glm::radians(90.0), glm::dvec3(0,1,0));
+        } else if (meta->axisForward == "-X") {
+            axis = glm::rotate(axis, glm::radians(-90.0), glm::dvec3(0,1,0));
+        }
+    }
+
+    out.reserve(scene->mNumMeshes);
     for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
         aiMesh* am = scene->mMeshes[i];
-        auto m = ModelLoader::processMesh(am, scene);
-        if (!m) continue;
-        if (am->mMaterialIndex < scene->mNumMaterials) {
-            const aiMaterial* mat = scene->mMaterials[am->mMaterialIndex];
-            AssignDiffuseTextureIfAny(mat, path, m);
-        }
-        if (hasMeta) {
-            double s = meta.meshScale;
-            glm::dmat4 axis = glm::dmat4(1.0);
-            if (meta.axisUp == "Z") {
-                axis = glm::rotate(axis, glm::radians(90.0), glm::dvec3(1,0,0));
-            }
-            if (meta.axisForward == "+Z") {
-                axis = axis * glm::dmat4(1.0);
-            } else if (meta.axisForward == "-Z") {
-                axis = glm::rotate(axis, glm::radians(180.0), glm::dvec3(0,1,0));
-            } else if (meta.axisForward == "+X") {
-                axis = glm::rotate(axis, glm::radians(90.0), glm::dvec3(0,1,0));
-            } else if (meta.axisForward == "-X") {
-                axis = glm::rotate(axis, glm::radians(-90.0), glm::dvec3(0,1,0));
-            }
-            for (auto& v : m->vertices) {
+        if (!am) continue;
+        out.emplace_back();
+        ImportedMesh& m = out.back();
+        ModelLoader::processMesh(am, scene, m);
+        if (meta) {
+            double s = meta->meshScale;
+            for (auto& v : m.vertices) {
                 glm::dvec4 p = axis * glm::dvec4(v.position, 1.0);
                 v.position = glm::dvec3(p) * s;
-                glm::dvec4 n = axis * glm::dvec4(v.normal, 0.0);
-                v.normal = glm::normalize(glm::dvec3(n));
+                glm::dvec4 n = axis * glm::dvec4(vec3(v.normal), 0.0);
+                v.normal = glm::vec3(glm::normalize(glm::dvec3(n)));
             }
-            m->computeAABB();
         }
-        meshes.push_back(m);
     }
-    return meshes;
+    return true;
+}
+
+bool ModelLoader::importToLibrary(const AssetMeta& meta, uint64_t importKey) {
+    std::vector<ImportedMesh> imported;
+    if (!importModel(meta.sourcePath, &meta, imported)) return false;
+    if (!MeshBlob::write(meta.libraryPath, importKey, imported)) return false;
+    LOG_INFO("Imported model to library: " + meta.libraryPath);
+    return true;
 }
 
-unsigned int ModelLoader::loadTexture(const std::string& path) {
-    EnsureDevILInited();
-    return LoadTexture2D(path);
+uint64_t ModelLoader::libraryKey(const AssetMeta& meta) {
+    MeshBlob blob;
+    return blob.open(meta.libraryPath) ? blob.importKey() : 0;
+}
+
+ModelSource ModelLoader::resolveSource(const std::string& path) {
+    ModelSource source;
+    source.path = path;
+    if (AssetMeta* dbMeta = AssetDatabase::instance().findAssetForFile(path)) {
+        source.meta = *dbMeta;
+        source.hasMeta = true;
+        source.libraryPath = dbMeta->libraryPath;
+    }
+    else if (AssetMeta::loadFromFile(path + ".meta", source.meta)) {
+        source.hasMeta = true;
+    }
+    return source;
+}
+
+bool ModelLoader::parseModel(const ModelSource& source, ParsedModel& out) {
+    out.subMeshes.clear();
+
+    // Camino rapido: blob de Library mapeado. No se copia nada: los meshes
+    // comparten el mapeo y suben streams e indices directamente desde el
+    if (!source.libraryPath.empty()) {
+        // Clave sobre una copia del meta: el hash del fuente, si hace falta, se hace aqui
+        AssetMeta meta = source.meta;
+        const uint64_t importKey = AssetDatabase::importKey(meta);
+        auto blob = std::make_shared<MeshBlob>();
+        if (blob->open(source.libraryPath) && blob->importKey() == importKey) {
+            out.subMeshes.resize(blob->subMeshCount());
+            for (size_t i = 0; i < blob->subMeshCount(); ++i) {
+                const MeshBlob::SubMesh sm = blob->subMesh(i);
+                ParsedSubMesh& sub = out.subMeshes[i];
+                sub.blob = blob;
+                sub.blobSubMesh = i;
+                sub.texture = sm.texture;
+                sub.vertexCount = sm.vertexCount;
+                sub.indexCount = sm.indexCount;
+                sub.packed = sm.packed;
+                sub.bounds = sm.bounds;
+            }
+            DecodeDiffuseTextures(source.path, out.subMeshes);
+            return true;
+        }
+    }
+
+    // Sin blob valido se importa de la fuente, sin escribir en Library: eso solo
+    // lo hace el AssetDatabase (importToLibrary), que es quien lo serializa
+    std::vector<ImportedMesh> imported;
+    if (!importModel(source.path, source.hasMeta ? &source.meta : nullptr, imported)) return false;
+
+    // Misma conversion que hace el blob, para que el hilo principal solo suba bytes
+    out.subMeshes.resize(imported.size());
+    std::vector<PackedVertex> packed;
+    std::vector<FloatVertex> floats;
+    for (size_t i = 0; i < imported.size(); ++i) {
+        ImportedMesh& im = imported[i];
+        ParsedSubMesh& sub = out.subMeshes[i];
+        sub.packed = Mesh::fitsPackedFormat(im.vertices);
+        const uint8_t* data;
+        size_t bytes;
+        if (sub.packed) {
+            Mesh::packVertices(im.vertices, packed);
+            data = reinterpret_cast<const uint8_t*>(packed.data());
+            bytes = packed.size() * sizeof(PackedVertex);
+        }
+        else {
+            Mesh::floatVertices(im.vertices, floats);
+            data = reinterpret_cast<const uint8_t*>(floats.data());
+            bytes = floats.size() * sizeof(FloatVertex);
+        }
+        sub.gpuStorage.assign(data, data + bytes);
+        for (const Vertex& v : im.vertices) sub.bounds.expand(v.position);
+        sub.vertexCount = im.vertices.size();
+        sub.indexCount = im.indices.size();
+        sub.vertices = std::move(im.vertices);
+        sub.indices = std::move(im.indices);
+        sub.texture = std::move(im.texture);
+    }
+    DecodeDiffuseTextures(source.path, out.subMeshes);
+    return true;
+}
+
+std::shared_ptr<Mesh> ModelLoader::uploadSubMesh(ParsedSubMesh& sub, TextureCache& textureCache) {
+    auto m = std::make_shared<Mesh>();
+    AssignDiffuseTextureIfAny(sub, m, textureCache);
+    if (sub.blob) {
+        m->setupMeshFromBlob(std::move(sub.blob), sub.blobSubMesh);
+        return m;
+    }
+    m->vertices = std::move(sub.vertices);
+    m->indices = std::move(sub.indices);
+    m->setupMeshFromStream(sub.gpuStorage.data(), sub.packed, sub.bounds);
+    return m;
 }
@@ -1,14 +1,78 @@
 #pragma once
 #include "Mesh.h"
+#include "MeshBlob.h"
+#include "AssetMeta.h"
+#include "TextureLoader.h"
 #include <string>
 #include <vector>
 #include <memory>
+#include <unordered_map>
+
+// Lo que la carga necesita del AssetDatabase, resuelto en el hilo principal.
+// La clave de importacion (hash del fuente) se calcula despues, en el worker
+struct ModelSource {
+    std::string path;
+    AssetMeta meta;
+    bool hasMeta = false;
+    std::string libraryPath; // Vacio: el modelo no esta en el AssetDatabase, no hay blob
+};
+
+// Sub-mesh listo para subir. Del blob solo se guarda que sub-mesh es: el Mesh
+// se queda con el mapeo y no se copia nada. Importado con Assimp, geometria de
+// CPU y vertices ya convertidos al formato de GPU
+struct ParsedSubMesh {
+    std::shared_ptr<const MeshBlob> blob;
+    size_t blobSubMesh = 0;
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<uint8_t> gpuStorage;
+    std::string texture;
+    // Textura difusa decodificada en el worker; solo en el primer sub-mesh que
+    // la usa, los demas la encuentran en el TextureCache al subir
+    std::unique_ptr<DecodedTexture> decodedTexture;
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    bool packed = false;
+    AABB bounds;
+
+    // Lo que cuesta subirlo: VBO + EBO + la textura si la trae
+    size_t uploadBytes() const {
+        return vertexCount * (packed ? sizeof(PackedVertex) : sizeof(FloatVertex))
+            + indexCount * sizeof(unsigned int)
+            + (decodedTexture ? decodedTexture->uploadBytes() : 0);
+    }
+};
+
+// Resultado de la fase de CPU de una carga
+struct ParsedModel {
+    std::vector<ParsedSubMesh> subMeshes;
+};
 
 class ModelLoader {
 public:
-    static std::vector<std::shared_ptr<Mesh>> loadModel(const std::string& path);
-    static GLuint loadTexture(const std::string& path);
+    // Entra en la clave de importacion: subirla cuando cambie lo que sale de
+    // importModel (flags de Assimp, conversion de vertices) o el MeshBlob
+    static const uint32_t kProcessorVersion = 1;
+
+    // Carga por fases, en segundo plano (AsyncModelLoader). Si el modelo esta en
+    // el AssetDatabase y la clave de su blob de Library coincide, se usa el blob
+    // mapeado sin pasar por Assimp; si no, se importa de la fuente.
+    // resolveSource consulta el AssetDatabase (hilo principal), parseModel lee
+    // el blob o importa con Assimp y decodifica las texturas sin tocar GL
+    // (cualquier hilo) y uploadSubMesh crea el Mesh y sube buffers y textura
+    // (hilo principal)
+    using TextureCache = std::unordered_map<std::string, std::shared_ptr<TextureResource>>;
+    static ModelSource resolveSource(const std::string& path);
+    static bool parseModel(const ModelSource& source, ParsedModel& out);
+    static std::shared_ptr<Mesh> uploadSubMesh(ParsedSubMesh& sub, TextureCache& textureCache);
+
+    // Assimp + ajustes del .meta (escala y ejes), sin GL
+    static bool importModel(const std::string& path, const AssetMeta* meta, std::vector<ImportedMesh>& out);
+    // Paso de importacion del AssetDatabase: escribe el blob en meta.libraryPath
+    static bool importToLibrary(const AssetMeta& meta, uint64_t importKey);
+    // Clave del blob de meta.libraryPath, o 0 si no hay un blob valido
+    static uint64_t libraryKey(const AssetMeta& meta);
 
 private:
-    static std::shared_ptr<Mesh> processMesh(void* mesh, const void* scene);
-};
\ No newline at end of file
+    static void processMesh(void* mesh, const void* scene, ImportedMesh& out);
+};
@@ -1,197 +1,264 @@
 #include "Octree.h"
-#include "Frustum.h" // [NEW] Needed for incomplete type in header
+#include "DebugDraw.h"
 #include <algorithm>
+#include <iterator>
 #include <iostream>
 
 /*-------------------------------------------------------------------------
-  OctreeNode Implementation
+  Helpers
 -------------------------------------------------------------------------*/
 
-// Constantes de configuración
-static int MAX_OBJECTS = 8;
-static int MAX_DEPTH = 6;
+static AABB looseBounds(const AABB& cell, double looseness) {
+    vec3 c = cell.center();
+    vec3 half = cell.size() * (0.5 * looseness);
+    return AABB(c - half, c + half);
+}
+
+static AABB worldAABBOf(const GameObject* go) {
+    return go->worldAABB();
+}
+
+static bool fitsInside(const AABB& outer, const AABB& inner) {
+    return inner.min.x >= outer.min.x && inner.max.x <= outer.max.x &&
+           inner.min.y >= outer.min.y && inner.max.y <= outer.max.y &&
+           inner.min.z >= outer.min.z && inner.max.z <= outer.max.z;
+}
+
+/*-------------------------------------------------------------------------
+  Octree Implementation
+-------------------------------------------------------------------------*/
+
+Octree::Octree(const AABB& rootRegion, int maxObj, int maxD, double loose)
+    : rootBounds(rootRegion), maxObjects(maxObj), maxDepthLevel(maxD), looseness(loose)
+{
+    clear();
+}
+
+void Octree::clear() {
+    for (auto& s : slots) {
+        if (s.object) s.object->octreeHandle = InvalidHandle;
+    }
+    // clear() conserva la capacidad: reconstruir no vuelve a reservar memoria
+    nodes.clear();
+    slots.clear();
+    owners.clear();
+    freeSlots.clear();
+    objectCount = 0;
+
+    OctreeNode root;
+    root.box = rootBounds;
+    root.looseBox = looseBounds(rootBounds, looseness);
+    nodes.push_back(root);
+}
+
+void Octree::rebuild(const std::vector<std::shared_ptr<GameObject>>& objects) {
+    clear();
+    slots.reserve(objects.size());
+    owners.reserve(objects.size());
+    for (const auto& go : objects) insert(go);
+}
 
-OctreeNode::OctreeNode(const AABB& bounds, int d) : box(bounds), depth(d) {
-    for (int i = 0; i < 8; ++i) children[i] = nullptr;
+bool Octree::contains(const GameObject* go) const {
+    return go && go->octreeHandle < slots.size() && slots[go->octreeHandle].object == go;
 }
 
-void OctreeNode::split() {
-    isLeaf = false;
+void Octree::split(uint32_t node) {
+    const uint32_t first = (uint32_t)nodes.size();
+    const AABB box = nodes[node].box;
+    const int depth = nodes[node].depth;
     vec3 center = box.center();
     vec3 min = box.min;
     vec3 max = box.max;
 
-    // Generar los 8 sub-nodos
-    // Hijos inferiores
-    children[0] = std::make_unique<OctreeNode>(AABB(min, center), depth + 1); // 000
-    children[1] = std::make_unique<OctreeNode>(AABB(vec3(center.x, min.y, min.z), vec3(max.x, center.y, center.z)), depth + 1); // 100
-    children[2] = std::make_unique<OctreeNode>(AABB(vec3(min.x, min.y, center.z), vec3(center.x, center.y, max.z)), depth + 1); // 001
-    children[3] = std::make_unique<OctreeNode>(AABB(vec3(center.x, min.y, center.z), vec3(max.x, center.y, max.z)), depth + 1); // 101
+    // Generar los 8 sub-nodos contiguos. Indice = x | z << 1 | y << 2
+    // 0:000 1:100 2:001 3:101 (inferiores) 4:010 5:110 6:011 7:111 (superiores)
+    for (int i = 0; i < 8; ++i) {
+        vec3 cMin((i & 1) ? center.x : min.x, (i & 4) ? center.y : min.y, (i & 2) ? center.z : min.z);
+        vec3 cMax((i & 1) ? max.x : center.x, (i & 4) ? max.y : center.y, (i & 2) ? max.z : center.z);
+        OctreeNode child;
+        child.box = AABB(cMin, cMax);
+        child.looseBox = looseBounds(child.box, looseness);
+        child.parent = node;
+        child.depth = depth + 1;
+        nodes.push_back(child);
+    }
+    nodes[node].firstChild = first;
+}
 
-    // Hijos superiores
-    children[4] = std::make_unique<OctreeNode>(AABB(vec3(min.x, center.y, min.z), vec3(center.x, max.y, center.z)), depth + 1); // 010
-    children[5] = std::make_unique<OctreeNode>(AABB(vec3(center.x, center.y, min.z), vec3(max.x, max.y, center.z)), depth + 1); // 110
-    children[6] = std::make_unique<OctreeNode>(AABB(vec3(min.x, center.y, center.z), vec3(center.x, max.y, max.z)), depth + 1); // 011
-    children[7] = std::make_unique<OctreeNode>(AABB(center, max), depth + 1); // 111
+uint32_t Octree::childFor(uint32_t node, const AABB& objBox) const {
+    const OctreeNode& n = nodes[node];
+    if (n.isLeaf()) return OctreeNode::kNone;
+    vec3 c = n.box.center();
+    vec3 p = objBox.center();
+    uint32_t child = n.firstChild + ((p.x >= c.x ? 1 : 0) | (p.z >= c.z ? 2 : 0) | (p.y >= c.y ? 4 : 0));
+    return fitsInside(nodes[child].looseBox, objBox) ? child : OctreeNode::kNone;
 }
 
-bool OctreeNode::insert(std::shared_ptr<GameObject> go) {
-    if (!go->mesh) return false;
-    mat4 worldMatrix = computeWorldMatrix(go.get());
-    AABB objBox = go->mesh->getWorldAABB(worldMatrix);
+void Octree::link(Handle h, uint32_t node) {
+    ObjectSlot& s = slots[h];
+    OctreeNode& n = nodes[node];
+    s.node = node;
+    s.prev = InvalidHandle;
+    s.next = n.firstObject;
+    if (n.firstObject != InvalidHandle) slots[n.firstObject].prev = h;
+    n.firstObject = h;
+    ++n.objectCount;
+}
 
-    if (!box.intersects(objBox)) return false; // El objeto no toca este nodo
+void Octree::unlink(Handle h) {
+    ObjectSlot& s = slots[h];
+    OctreeNode& n = nodes[s.node];
+    if (s.prev != InvalidHandle) slots[s.prev].next = s.next;
+    else n.firstObject = s.next;
+    if (s.next != InvalidHandle) slots[s.next].prev = s.prev;
+    --n.objectCount;
+    s.node = OctreeNode::kNone;
+    s.next = s.prev = InvalidHandle;
+}
 
-    // Si es hoja y hay espacio, o nivel máx, insertar aquí
-    if (isLeaf) {
-        if (objects.size() < MAX_OBJECTS || depth >= MAX_DEPTH) {
-            objects.push_back(go);
-            return true;
-        }
-        else {
-            split();
-            // Mover objetos existentes a los hijos
-            while (!objects.empty()) {
-                auto obj = objects.back();
-                objects.pop_back();
-                bool insertedInChild = false;
-                for (int i = 0; i < 8; ++i) {
-                    if (children[i]->insert(obj)) {
-                        insertedInChild = true;
-                        // Nota: Un objeto puede estar en múltiples nodos si intersecta
-                        // pero para simplificar, a menudo se intenta poner solo en 
-                        // el nodo más pequeño que lo contenga. 
-                        // PERO, la lógica simple de Octree es: si cabe, va al hijo.
-                        // Si el objeto es grande, podría tener que quedarse en el padre.
-                        // IMPLEMENTACION SIMPLE:
-                        // Si intersecta con un hijo, lo metemos en ese hijo. 
-                        // Si intersecta con varios, se duplica la referencia (no el objeto).
-                    }
-                }
-            }
-        }
+void Octree::insert(std::shared_ptr<GameObject> go) {
+    if (!go || !go->mesh) return;
+    if (contains(go.get())) { update(go.get()); return; }
+
+    Handle h;
+    if (!freeSlots.empty()) {
+        h = freeSlots.back();
+        freeSlots.pop_back();
     }
-    
-    // Si no es hoja, intentar meter en hijos
-    if (!isLeaf) {
-        bool inChild = false;
-        for (int i = 0; i < 8; ++i) {
-            if (children[i]->insert(go)) inChild = true;
-        }
-        return inChild;
+    else {
+        h = (Handle)slots.size();
+        slots.emplace_back();
+        owners.emplace_back();
     }
+    slots[h].object = go.get();
+    go->octreeHandle = h;
+    AABB objBox = worldAABBOf(go.get());
+    slots[h].bounds = objBox;
+    owners[h] = std::move(go);
+    ++objectCount;
 
-    return false; // Should not reach here
+    // Los objetos fuera de los limites mundiales se quedan en la raiz,
+    // cuya looseBox crece para englobarlos.
+    insertInto(0, h, objBox);
 }
 
-void OctreeNode::collectIntersections(const Frustum& frustum, std::list<std::shared_ptr<GameObject>>& results) const {
-    if (!frustum.containsAABB(box)) return;
+void Octree::insertInto(uint32_t node, Handle h, const AABB& objBox) {
+    // Bajar mientras el hijo correspondiente al centro contenga el objeto entero
+    for (uint32_t child = childFor(node, objBox); child != OctreeNode::kNone; child = childFor(node, objBox))
+        node = child;
+    if (node == 0) nodes[0].looseBox.merge(objBox);
+    link(h, node);
 
-    for (const auto& obj : objects) {
-        results.push_back(obj);
-    }
-    if (!isLeaf) {
-        for (int i = 0; i < 8; ++i) {
-            children[i]->collectIntersections(frustum, results);
+    // Subdividir la hoja si se llena, y empujar hacia abajo lo que quepa
+    if (nodes[node].isLeaf() && (int)nodes[node].objectCount > maxObjects && nodes[node].depth < maxDepthLevel) {
+        split(node);
+        Handle it = nodes[node].firstObject;
+        while (it != InvalidHandle) {
+            Handle next = slots[it].next;
+            uint32_t child = childFor(node, slots[it].bounds);
+            if (child != OctreeNode::kNone) {
+                unlink(it);
+                link(it, child);
+            }
+            it = next;
         }
     }
 }
 
-void OctreeNode::collectIntersections(const Ray& ray, std::list<std::shared_ptr<GameObject>>& results) const {
-    double t;
-    if (!ray.intersectsAABB(box, t)) return;
+bool Octree::remove(GameObject* go) {
+    if (!contains(go)) return false;
+    Handle h = go->octreeHandle;
+    unlink(h);
+    slots[h].object = nullptr;
+    owners[h].reset();
+    freeSlots.push_back(h);
+    go->octreeHandle = InvalidHandle;
+    --objectCount;
+    return true;
+}
 
-    for (const auto& obj : objects) {
-        results.push_back(obj);
-    }
+bool Octree::update(GameObject* go) {
+    if (!contains(go)) return false;
+    if (!go->mesh) { remove(go); return false; }
 
-    if (!isLeaf) {
-        // Ordenar hijos por distancia podría optimizar, pero overkill por ahora
-        for (int i = 0; i < 8; ++i) {
-            children[i]->collectIntersections(ray, results);
-        }
-    }
-}
+    Handle h = go->octreeHandle;
+    uint32_t node = slots[h].node;
+    AABB objBox = worldAABBOf(go);
+    slots[h].bounds = objBox;
 
-void OctreeNode::drawDebug() const {
-    // Dibujar caja del nodo
-    glDisable(GL_LIGHTING);
-    glColor3f(0.0f, 1.0f, 1.0f); // Cyan para nodos
-    glLineWidth(1.0f);
-    
-    vec3 min = box.min;
-    vec3 max = box.max;
-    
-    glBegin(GL_LINES);
-    glVertex3d(min.x, min.y, min.z); glVertex3d(max.x, min.y, min.z);
-    glVertex3d(max.x, min.y, min.z); glVertex3d(max.x, min.y, max.z);
-    glVertex3d(max.x, min.y, max.z); glVertex3d(min.x, min.y, max.z);
-    glVertex3d(min.x, min.y, max.z); glVertex3d(min.x, min.y, min.z);
-
-    glVertex3d(min.x, max.y, min.z); glVertex3d(max.x, max.y, min.z);
-    glVertex3d(max.x, max.y, min.z); glVertex3d(max.x, max.y, max.z);
-    glVertex3d(max.x, max.y, max.z); glVertex3d(min.x, max.y, max.z);
-    glVertex3d(min.x, max.y, max.z); glVertex3d(min.x, max.y, min.z);
-
-    glVertex3d(min.x, min.y, min.z); glVertex3d(min.x, max.y, min.z);
-    glVertex3d(max.x, min.y, min.z); glVertex3d(max.x, max.y, min.z);
-    glVertex3d(max.x, min.y, max.z); glVertex3d(max.x, max.y, max.z);
-    glVertex3d(min.x, min.y, max.z); glVertex3d(min.x, max.y, max.z);
-    glEnd();
-    glEnable(GL_LIGHTING);
-
-    if (!isLeaf) {
-        for (int i = 0; i < 8; ++i) {
-            children[i]->drawDebug();
-        }
+    // Si sigue cabiendo en su nodo y no puede bajar a un hijo, no hay nada que hacer
+    if (node == 0 || fitsInside(nodes[node].looseBox, objBox)) {
+        if (node == 0) nodes[0].looseBox.merge(objBox);
+        if (childFor(node, objBox) == OctreeNode::kNone) return true;
     }
-}
 
+    unlink(h);
+    uint32_t target = node;
+    while (target != 0 && !fitsInside(nodes[target].looseBox, objBox)) target = nodes[target].parent;
+    insertInto(target, h, objBox);
+    return true;
+}
 
-/*-------------------------------------------------------------------------
-  Octree Implementation
--------------------------------------------------------------------------*/
+void Octree::queryFrustum(const Frustum& frustum, std::vector<GameObject*>& results) const {
+    results.clear();
+    // Cada objeto vive en un solo nodo: no hace falta eliminar duplicados
+    queryFrustum(frustum, std::back_inserter(results));
+}
 
-Octree::Octree(const AABB& rootRegion, int maxObj, int maxD) 
-    : rootBounds(rootRegion), maxObjects(maxObj), maxDepthLevel(maxD) 
-{
-    MAX_OBJECTS = maxObj;
-    MAX_DEPTH = maxD;
-    clear();
+void Octree::queryRay(const Ray& ray, std::vector<GameObject*>& results) const {
+    results.clear();
+    queryRay(ray, std::back_inserter(results));
 }
 
-void Octree::clear() {
-    root = std::make_unique<OctreeNode>(rootBounds, 0);
+GameObject* Octree::raycastClosest(const Ray& ray, double maxDistance, MeshBVH::Hit* outHit) const {
+    GameObject* best = nullptr;
+    MeshBVH::Hit hit;
+    hit.t = maxDistance;
+    double t;
+    if (ray.intersectsAABB(nodes[0].looseBox, t) && t < hit.t)
+        raycastNode(0, ray, best, hit);
+    if (best && outHit) *outHit = hit;
+    return best;
 }
 
-void Octree::insert(std::shared_ptr<GameObject> go) {
-    if (!root) return;
-    // Si el objeto está fuera de los límites mundiales, podríamos expandir, 
-    // pero por ahora lo ignoramos o lo forzamos.
-    root->insert(go);
-}
-
-std::list<std::shared_ptr<GameObject>> Octree::queryFrustum(const Frustum& frustum) const {
-    std::list<std::shared_ptr<GameObject>> results;
-    if (root) {
-        root->collectIntersections(frustum, results);
-        // Eliminar duplicados (porque un objeto puede estar en varios nodos)
-        results.sort();
-        results.unique();
+void Octree::raycastNode(uint32_t node, const Ray& ray, GameObject*& best, MeshBVH::Hit& hit) const {
+    const OctreeNode& n = nodes[node];
+    double t;
+    for (Handle h = n.firstObject; h != InvalidHandle; h = slots[h].next) {
+        // La AABB descarta barato; el test de triangulos solo si podria mejorar el hit
+        if (ray.intersectsAABB(slots[h].bounds, t) && t < hit.t) {
+            if (slots[h].object->raycast(ray, hit)) best = slots[h].object;
+        }
+    }
+    if (n.isLeaf()) return;
+
+    // Hijos que corta el rayo, ordenados por t de entrada (insercion, son 8 como mucho)
+    uint32_t order[8];
+    double entry[8];
+    int count = 0;
+    for (uint32_t i = 0; i < 8; ++i) {
+        uint32_t child = n.firstChild + i;
+        if (!ray.intersectsAABB(nodes[child].looseBox, t) || t >= hit.t) continue;
+        int j = count++;
+        for (; j > 0 && entry[j - 1] > t; --j) {
+            entry[j] = entry[j - 1];
+            order[j] = order[j - 1];
+        }
+        entry[j] = t;
+        order[j] = child;
     }
-    return results;
-}
 
-std::list<std::shared_ptr<GameObject>> Octree::queryRay(const Ray& ray) const {
-    std::list<std::shared_ptr<GameObject>> results;
-    if (root) {
-        root->collectIntersections(ray, results);
-        results.sort();
-        results.unique();
+    // Todo lo de un hijo esta dentro de su looseBox: si entra despues del mejor hit, sobra
+    for (int i = 0; i < count; ++i) {
+        if (entry[i] >= hit.t) break;
+        raycastNode(order[i], ray, best, hit);
     }
-    return results;
 }
 
 void Octree::drawDebug() const {
-    if (root) root->drawDebug();
+    // Caja de cada nodo en cyan; el pool es plano, no hace falta recursion.
+    // Se acumulan en DebugDraw y salen en el mismo draw que el resto de lineas.
+    DebugDraw& dd = DebugDraw::instance();
+    const glm::u8vec3 cyan(0, 255, 255);
+    for (const OctreeNode& n : nodes) dd.box(n.box, cyan, 1.0f);
 }
@@ -1,47 +1,171 @@
 #pragma once
 #include "AABB.h"
+#include "Frustum.h"
+#include "FrustumBatch.h"
 #include "GameObject.h"
 #include <vector>
 #include <memory>
-#include <list>
-#include <list>
+#include <cstdint>
+#include <limits>
 #include <GL/glew.h>
 
-class Frustum; // Forward declaration
+// Nodo de un loose octree: cada objeto vive en un unico nodo, el mas profundo
+// cuya caja ampliada (looseBox) lo contiene por completo.
+// Los nodos viven en un pool contiguo y se referencian por indice.
+struct OctreeNode {
+    static constexpr uint32_t kNone = 0xFFFFFFFFu;
 
-class OctreeNode {
-public:
-    AABB box;
-    std::vector<std::shared_ptr<GameObject>> objects; // Objetos en este nodo
-    std::unique_ptr<OctreeNode> children[8];
-    bool isLeaf = true;
+    AABB box;      // Celda exacta
+    AABB looseBox; // Celda ampliada por el factor de holgura
+    uint32_t firstChild = 0;       // Los 8 hijos son contiguos; 0 = hoja (la raiz nunca es hija)
+    uint32_t parent = kNone;
+    uint32_t firstObject = kNone;  // Cabeza de la lista de objetos (handle)
+    uint32_t objectCount = 0;
     int depth = 0;
 
-    OctreeNode(const AABB& bounds, int d);
-    
-    void split();
-    bool insert(std::shared_ptr<GameObject> go);
-    void collectIntersections(const Frustum& frustum, std::list<std::shared_ptr<GameObject>>& results) const;
-    void collectIntersections(const Ray& ray, std::list<std::shared_ptr<GameObject>>& results) const;
-    void drawDebug() const;
+    bool isLeaf() const { return firstChild == 0; }
 };
 
 class Octree {
 public:
-    Octree(const AABB& rootRegion, int maxObjectsPerNode = 8, int maxDepth = 6);
-    
+    using Handle = uint32_t;
+    static constexpr Handle InvalidHandle = OctreeNode::kNone;
+
+    Octree(const AABB& rootRegion, int maxObjectsPerNode = 8, int maxDepth = 6, double looseness = 2.0);
+
     void clear();
+    // Vacia el arbol e inserta todos los objetos reutilizando la memoria ya reservada
+    void rebuild(const std::vector<std::shared_ptr<GameObject>>& objects);
     void insert(std::shared_ptr<GameObject> go);
-    
-    // Devuelve lista de objetos candidatos
-    std::list<std::shared_ptr<GameObject>> queryFrustum(const Frustum& frustum) const;
-    std::list<std::shared_ptr<GameObject>> queryRay(const Ray& ray) const;
+    // Quita el objeto del arbol usando su handle (O(1))
+    bool remove(GameObject* go);
+    // Recoloca un objeto tras moverlo o cambiar su mesh, en O(profundidad)
+    bool update(GameObject* go);
+    bool contains(const GameObject* go) const;
+    size_t size() const { return objectCount; }
+    size_t nodeCount() const { return nodes.size(); }
+
+    // Objetos candidatos. El vector del llamador se vacia y se reutiliza, de modo
+    // que con capacidad suficiente la consulta no reserva memoria.
+    void queryFrustum(const Frustum& frustum, std::vector<GameObject*>& results) const;
+    void queryRay(const Ray& ray, std::vector<GameObject*>& results) const;
+
+    // Variante con output iterator: escribe GameObject* sin tocar refcounts
+    template<class OutputIt>
+    OutputIt queryFrustum(const Frustum& frustum, OutputIt out) const {
+        collectIntersections(0, frustum, Frustum::ALL_PLANES, out);
+        return out;
+    }
+    template<class OutputIt>
+    OutputIt queryRay(const Ray& ray, OutputIt out) const {
+        collectIntersections(0, ray, out);
+        return out;
+    }
+
+    // Objeto cuyo mesh corta antes el rayo (nullptr si ninguno antes de maxDistance).
+    // La AABB solo filtra; el hit es el triangulo exacto, via el BVH del mesh.
+    // Recorre los hijos de delante hacia atras y corta en cuanto el hit mas
+    // cercano queda antes de la entrada al siguiente nodo.
+    GameObject* raycastClosest(const Ray& ray, double maxDistance = std::numeric_limits<double>::max(),
+                               MeshBVH::Hit* outHit = nullptr) const;
 
     void drawDebug() const;
 
 private:
-    std::unique_ptr<OctreeNode> root;
+    // Entrada del array de objetos; las listas de cada nodo se enlazan por handle
+    struct ObjectSlot {
+        GameObject* object = nullptr;
+        AABB bounds;                      // AABB en mundo, guardada al insertar/actualizar
+        uint32_t node = OctreeNode::kNone;
+        Handle next = InvalidHandle;
+        Handle prev = InvalidHandle;
+    };
+
+    std::vector<OctreeNode> nodes;  // nodes[0] es la raiz
+    std::vector<ObjectSlot> slots;
+    std::vector<std::shared_ptr<GameObject>> owners; // Paralelo a slots; solo se toca al insertar/quitar
+    std::vector<Handle> freeSlots;
+
     AABB rootBounds;
     int maxObjects;
     int maxDepthLevel;
+    double looseness;
+    size_t objectCount = 0;
+
+    // Scratch para el test SIMD de los objetos de un nodo; solo se usa antes de
+    // bajar a los hijos, asi que la recursion puede reutilizarlo
+    mutable AABBBatch batchBoxes;
+    mutable std::vector<Handle> batchHandles;
+    mutable std::vector<uint8_t> batchVisible;
+
+    void split(uint32_t node);
+    uint32_t childFor(uint32_t node, const AABB& objBox) const;
+    void link(Handle h, uint32_t node);
+    void unlink(Handle h);
+    void insertInto(uint32_t node, Handle h, const AABB& objBox);
+    void raycastNode(uint32_t node, const Ray& ray, GameObject*& best, MeshBVH::Hit& hit) const;
+
+    // planeMask: planos que el padre aun corta. Los hijos estan dentro de la
+    // looseBox del padre, asi que no hace falta volver a probar los demas.
+    template<class OutputIt>
+    void collectIntersections(uint32_t node, const Frustum& frustum, unsigned planeMask, OutputIt& out) const {
+        const OctreeNode& n = nodes[node];
+        Frustum::Containment c = frustum.classifyAABB(n.looseBox, planeMask);
+        if (c == Frustum::OUTSIDE) return;
+        if (c == Frustum::INSIDE) {
+            // Todo el subarbol es visible: volcarlo sin mas tests
+            collectAll(node, out);
+            return;
+        }
+
+        // El nodo corta el frustum: testear sus objetos en lote contra los planos que quedan
+        if (n.firstObject != InvalidHandle) {
+            batchBoxes.clear();
+            batchHandles.clear();
+            for (Handle h = n.firstObject; h != InvalidHandle; h = slots[h].next) {
+                batchBoxes.push(slots[h].bounds);
+                batchHandles.push_back(h);
+            }
+            FrustumBatch::cull(frustum, batchBoxes, batchVisible, planeMask);
+            for (size_t i = 0; i < batchHandles.size(); ++i) {
+                if (batchVisible[i]) *out++ = slots[batchHandles[i]].object;
+            }
+        }
+        if (!n.isLeaf()) {
+            for (uint32_t i = 0; i < 8; ++i) {
+                collectIntersections(n.firstChild + i, frustum, planeMask, out);
+            }
+        }
+    }
+
+    template<class OutputIt>
+    void collectAll(uint32_t node, OutputIt& out) const {
+        const OctreeNode& n = nodes[node];
+        for (Handle h = n.firstObject; h != InvalidHandle; h = slots[h].next) {
+            *out++ = slots[h].object;
+        }
+        if (!n.isLeaf()) {
+            for (uint32_t i = 0; i < 8; ++i) {
+                collectAll(n.firstChild + i, out);
+            }
+        }
+    }
+
+    template<class OutputIt>
+    void collectIntersections(uint32_t node, const Ray& ray, OutputIt& out) const {
+        const OctreeNode& n = nodes[node];
+        double t;
+        if (!ray.intersectsAABB(n.looseBox, t)) return;
+
+        for (Handle h = n.firstObject; h != InvalidHandle; h = slots[h].next) {
+            *out++ = slots[h].object;
+        }
+        if (!n.isLeaf()) {
+            // Sin orden: devuelve todos los candidatos. El mas cercano, con los hijos
+            // ordenados por distancia y poda, es raycastClosest
+            for (uint32_t i = 0; i < 8; ++i) {
+                collectIntersections(n.firstChild + i, ray, out);
+            }
+        }
+    }
 };
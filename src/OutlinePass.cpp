@@ -0,0 +1,123 @@
+#include "OutlinePass.h"
+#include "Renderer.h"
+#include "Framebuffer.h"
+#include "Logger.h"
+#include <string>
+
+static const char* kOutlineVertexShader = R"(#version 330 core
+void main() {
+    // Triangulo que cubre toda la pantalla: (-1,-1), (3,-1), (-1,3)
+    vec2 p = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(p * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+static const char* kOutlineFragmentShader = R"(#version 330 core
+uniform usampler2D uStencil;
+uniform vec4 uColor;
+uniform int uRadius;
+out vec4 fragColor;
+void main() {
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    if (texelFetch(uStencil, p, 0).r != 0u) discard;
+    ivec2 last = textureSize(uStencil, 0) - 1;
+    for (int y = -uRadius; y <= uRadius; ++y) {
+        for (int x = -uRadius; x <= uRadius; ++x) {
+            if (texelFetch(uStencil, clamp(p + ivec2(x, y), ivec2(0), last), 0).r != 0u) {
+                fragColor = uColor;
+                return;
+            }
+        }
+    }
+    discard;
+}
+)";
+
+static GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+    GLint ok = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024] = { 0 };
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        LOG_ERROR(std::string("Outline shader error: ") + log);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+OutlinePass& OutlinePass::instance() {
+    static OutlinePass g;
+    return g;
+}
+
+bool OutlinePass::init() {
+    if (!Renderer::instance().isShader()) return false;
+    if (!GLEW_VERSION_4_3 && !GLEW_ARB_stencil_texturing) {
+        LOG_INFO("Selection outline: stencil texturing not available, using wireframe");
+        return false;
+    }
+    if (!buildProgram()) {
+        LOG_WARN("Selection outline: shader setup failed, using wireframe");
+        return false;
+    }
+    glGenVertexArrays(1, &vao_);
+    return true;
+}
+
+bool OutlinePass::buildProgram() {
+    GLuint vs = compileShader(GL_VERTEX_SHADER, kOutlineVertexShader);
+    GLuint fs = compileShader(GL_FRAGMENT_SHADER, kOutlineFragmentShader);
+    if (!vs || !fs) {
+        if (vs) glDeleteShader(vs);
+        if (fs) glDeleteShader(fs);
+        return false;
+    }
+    program_ = glCreateProgram();
+    glAttachShader(program_, vs);
+    glAttachShader(program_, fs);
+    glLinkProgram(program_);
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+    GLint ok = GL_FALSE;
+    glGetProgramiv(program_, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        glDeleteProgram(program_);
+        program_ = 0;
+        return false;
+    }
+    uStencil_ = glGetUniformLocation(program_, "uStencil");
+    uColor_ = glGetUniformLocation(program_, "uColor");
+    uRadius_ = glGetUniformLocation(program_, "uRadius");
+    return true;
+}
+
+void OutlinePass::shutdown() {
+    if (vao_) { glDeleteVertexArrays(1, &vao_); vao_ = 0; }
+    if (program_) { glDeleteProgram(program_); program_ = 0; }
+}
+
+void OutlinePass::draw(Framebuffer& fb) {
+    if (!isEnabled() || !fb.GetDepthStencilTextureID()) return;
+    if (!Renderer::instance().selectionInLastPass()) return;
+
+    // Se muestrea el stencil: fuera del framebuffer mientras dura la pasada
+    fb.AttachDepthStencil(false);
+    glDisable(GL_DEPTH_TEST);
+    glUseProgram(program_);
+    glUniform1i(uStencil_, 0);
+    glUniform4f(uColor_, 1.0f, 1.0f, 0.0f, 1.0f); // Amarillo, como el alambre
+    glUniform1i(uRadius_, kRadius);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, fb.GetDepthStencilTextureID());
+    glBindVertexArray(vao_);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+    glEnable(GL_DEPTH_TEST);
+    fb.AttachDepthStencil(true);
+}
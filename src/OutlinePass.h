@@ -0,0 +1,43 @@
+#pragma once
+#include <GL/glew.h>
+
+class Framebuffer;
+
+// Contorno de seleccion en post-proceso. El Renderer pinta el seleccionado
+// marcando stencil = 1 (RenderQueue::SelectedOpaque) y aqui un triangulo a
+// pantalla completa lee el stencil como textura y colorea los pixeles sin
+// marcar que tienen alguno marcado a menos de kRadius pixeles. Sustituye a la
+// segunda pasada en alambre (GL_LINE), que es muy lenta en meshes grandes.
+// Necesita el renderer GLSL y ARB_stencil_texturing (GL 4.3); si no, el
+// Renderer sigue con el alambre.
+class OutlinePass {
+public:
+    static OutlinePass& instance();
+
+    // Llamar despues de Renderer::init
+    bool init();
+    void shutdown();
+
+    bool isAvailable() const { return program_ != 0; }
+    bool isEnabled() const { return enabled_ && isAvailable(); }
+    void setEnabled(bool enabled) { enabled_ = enabled; }
+
+    // Con fb enlazado, despues de la pasada de objetos. No hace nada si la
+    // pasada no marco ningun objeto o fb no tiene el depth/stencil en textura
+    void draw(Framebuffer& fb);
+
+private:
+    OutlinePass() = default;
+    OutlinePass(const OutlinePass&) = delete;
+    OutlinePass& operator=(const OutlinePass&) = delete;
+
+    bool buildProgram();
+
+    static constexpr int kRadius = 2;
+    GLuint program_ = 0;
+    GLuint vao_ = 0; // Vacio: el triangulo sale de gl_VertexID
+    GLint uStencil_ = -1;
+    GLint uColor_ = -1;
+    GLint uRadius_ = -1;
+    bool enabled_ = true;
+};
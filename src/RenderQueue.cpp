@@ -0,0 +1,65 @@
+#include "RenderQueue.h"
+#include <cstring>
+#include <utility>
+
+uint64_t RenderQueue::makeKey(unsigned pass, unsigned program, GLuint texture, GLuint vao, float viewDepth) {
+    // Para floats positivos el patron de bits crece con el valor: los 24 bits
+    // altos sirven de profundidad cuantizada sin conocer near/far
+    if (!(viewDepth > 0.0f)) viewDepth = 0.0f;
+    uint32_t depthBits;
+    std::memcpy(&depthBits, &viewDepth, sizeof(depthBits));
+
+    return (uint64_t(pass & 0x3u) << 62)
+         | (uint64_t(program & 0xFu) << 58)
+         | (uint64_t(texture & 0xFFFFu) << 42)
+         | (uint64_t(vao & 0x3FFFFu) << 24)
+         | uint64_t(depthBits >> 8);
+}
+
+void RenderQueue::clear() {
+    items_.clear();
+    keys_.clear();
+    order_.clear();
+}
+
+void RenderQueue::push(const RenderItem& item, uint64_t key) {
+    items_.push_back(item);
+    keys_.push_back(key);
+}
+
+void RenderQueue::sort() {
+    const size_t n = keys_.size();
+    order_.resize(n);
+    for (size_t i = 0; i < n; ++i) order_[i] = (uint32_t)i;
+    if (n < 2) return;
+
+    // Los 8 histogramas en una sola lectura de las claves
+    uint32_t counts[8][256];
+    std::memset(counts, 0, sizeof(counts));
+    for (uint64_t k : keys_) {
+        for (int b = 0; b < 8; ++b) ++counts[b][(k >> (b * 8)) & 0xFF];
+    }
+
+    keysTmp_.resize(n);
+    orderTmp_.resize(n);
+    for (int b = 0; b < 8; ++b) {
+        const int shift = b * 8;
+        uint32_t* count = counts[b];
+        // Todas las claves tienen el mismo byte: la pasada no cambiaria nada
+        if (count[(keys_[0] >> shift) & 0xFF] == n) continue;
+
+        uint32_t offset = 0;
+        for (int d = 0; d < 256; ++d) {
+            uint32_t c = count[d];
+            count[d] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            const uint32_t dst = count[(keys_[i] >> shift) & 0xFF]++;
+            keysTmp_[dst] = keys_[i];
+            orderTmp_[dst] = order_[i];
+        }
+        std::swap(keys_, keysTmp_);
+        std::swap(order_, orderTmp_);
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <GL/glew.h>
+
+class GameObject;
+class Mesh;
+
+// Un draw pendiente. La clave de orden se guarda aparte, en RenderQueue.
+struct RenderItem {
+    const GameObject* object = nullptr;
+    const Mesh* mesh = nullptr;
+    GLuint texture = 0;
+    uint8_t pass = 0;
+};
+
+// Cola de draws de una pasada. Cada draw lleva una clave de 64 bits:
+//
+//   63..62  pasada (contorno de seleccion, opacos, seleccionado con stencil)
+//   61..58  programa
+//   57..42  textura  (nombre GL, 16 bits)
+//   41..24  mesh     (nombre del VAO, 18 bits)
+//   23..0   profundidad en vista, de delante a atras
+//
+// Ordenar por la clave agrupa los draws que comparten estado, asi el renderer
+// puede saltarse los binds repetidos. Si dos nombres GL coinciden en los bits
+// recortados solo se pierde agrupacion, nunca se dibuja mal: el draw usa los
+// datos del RenderItem, no la clave.
+class RenderQueue {
+public:
+    enum Pass : uint8_t {
+        SelectionOutline = 0, // Se dibuja primero: el relleno a la misma profundidad no lo tapa (GL_LESS)
+        Opaque = 1,
+        SelectedOpaque = 2    // Relleno del seleccionado marcando stencil = 1 (contorno en post-proceso)
+    };
+
+    static uint64_t makeKey(unsigned pass, unsigned program, GLuint texture, GLuint vao, float viewDepth);
+
+    void clear();
+    void push(const RenderItem& item, uint64_t key);
+    // Radix sort LSD de 8 bits, estable; se salta los bytes iguales en todas las claves
+    void sort();
+
+    size_t size() const { return items_.size(); }
+    bool empty() const { return items_.empty(); }
+    // Tras sort(), en orden de clave
+    const RenderItem& operator[](size_t i) const { return items_[order_[i]]; }
+    uint64_t key(size_t i) const { return keys_[i]; }
+
+private:
+    std::vector<RenderItem> items_;
+    std::vector<uint64_t> keys_, keysTmp_;
+    std::vector<uint32_t> order_, orderTmp_;
+};
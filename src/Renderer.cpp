@@ -0,0 +1,650 @@
+#include "Renderer.h"
+#include "GameObject.h"
+#include "StaticBatcher.h"
+#include "MeshArena.h"
+#include "Logger.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+static const GLuint kCameraBinding = 0;
+static const size_t kRingFrameBytes = 4u << 20; // Crece si una frame no cabe
+static const GLuint kInstanceModelAttrib = 3;  // 4 columnas: 3..6
+static const GLuint kInstanceNormalAttrib = 7; // 3 columnas: 7..9
+
+// El contorno de alambre va sin textura; los rellenos la llevan
+static bool passUsesTexture(int pass) {
+    return pass != RenderQueue::SelectionOutline;
+}
+
+static const char* kVertexShader = R"(#version 330 core
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec2 aTexCoord;
+
+layout(std140) uniform Camera {
+    mat4 view;
+    mat4 proj;
+    mat4 viewProj;
+    vec4 lightPosView;
+};
+
+// Por instancia, del buffer de instancias (glVertexAttribDivisor 1)
+layout(location = 3) in mat4 aModel;        // 3..6
+layout(location = 7) in mat3 aNormalMatrix; // 7..9
+
+out vec3 vPosView;
+out vec3 vNormalView;
+out vec2 vTexCoord;
+
+void main() {
+    vec4 posView = view * (aModel * vec4(aPosition, 1.0));
+    vPosView = posView.xyz;
+    vNormalView = mat3(view) * (aNormalMatrix * aNormal);
+    vTexCoord = aTexCoord;
+    gl_Position = proj * posView;
+}
+)";
+
+// Misma iluminacion que el camino legacy: ambiente global 0.2 + luz 0.3, difusa 0.8,
+// color de material = color actual (GL_COLOR_MATERIAL) modulado por la textura
+static const char* kFragmentShader = R"(#version 330 core
+in vec3 vPosView;
+in vec3 vNormalView;
+in vec2 vTexCoord;
+
+layout(std140) uniform Camera {
+    mat4 view;
+    mat4 proj;
+    mat4 viewProj;
+    vec4 lightPosView;
+};
+
+uniform vec4 uColor;
+uniform bool uLit;
+uniform bool uHasTexture;
+uniform sampler2D uTexture;
+
+out vec4 fragColor;
+
+void main() {
+    vec4 base = uColor;
+    if (uHasTexture) base *= texture(uTexture, vTexCoord);
+    if (uLit) {
+        vec3 N = normalize(vNormalView);
+        if (!gl_FrontFacing) N = -N;
+        vec3 L = normalize(lightPosView.xyz - vPosView);
+        float diffuse = max(dot(N, L), 0.0);
+        base.rgb *= min(vec3(0.5 + 0.8 * diffuse), vec3(1.0));
+    }
+    fragColor = base;
+}
+)";
+
+static GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+    GLint ok = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024] = { 0 };
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        LOG_ERROR(std::string("Shader compile error: ") + log);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+Renderer& Renderer::instance() {
+    static Renderer g;
+    return g;
+}
+
+const char* Renderer::backendName() const {
+    return isShader() ? "GLSL 3.3" : "Legacy (fixed function)";
+}
+
+bool Renderer::init(RenderBackend requested) {
+    backend_ = RenderBackend::Legacy;
+    if (requested == RenderBackend::Legacy) {
+        LOG_INFO("Renderer: legacy fixed-function path");
+        return true;
+    }
+    if (!GLEW_VERSION_3_3) {
+        LOG_WARN("Renderer: OpenGL 3.3 not available, using legacy path");
+        return false;
+    }
+    if (!buildProgram()) {
+        LOG_WARN("Renderer: shader setup failed, using legacy path");
+        return false;
+    }
+
+    // Camara, instancias y comandos indirect se reparten en el mismo ring
+    GLint uboAlignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uboAlignment);
+    uboAlignment_ = uboAlignment > 0 ? (size_t)uboAlignment : 256;
+    if (!ring_.init(kRingFrameBytes)) {
+        LOG_WARN("Renderer: could not create the dynamic ring buffer, using legacy path");
+        glDeleteProgram(program_);
+        program_ = 0;
+        return false;
+    }
+    indirectSupported_ = MeshArena::supported();
+    indirect_ = indirectSupported_;
+
+    backend_ = RenderBackend::Shader;
+    LOG_INFO(indirectSupported_ ? "Renderer: GLSL 3.3 path, multi-draw indirect available"
+                                : "Renderer: GLSL 3.3 path");
+    return true;
+}
+
+bool Renderer::buildProgram() {
+    GLuint vs = compileShader(GL_VERTEX_SHADER, kVertexShader);
+    GLuint fs = compileShader(GL_FRAGMENT_SHADER, kFragmentShader);
+    if (!vs || !fs) {
+        if (vs) glDeleteShader(vs);
+        if (fs) glDeleteShader(fs);
+        return false;
+    }
+    program_ = glCreateProgram();
+    glAttachShader(program_, vs);
+    glAttachShader(program_, fs);
+    glLinkProgram(program_);
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+
+    GLint ok = GL_FALSE;
+    glGetProgramiv(program_, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[1024] = { 0 };
+        glGetProgramInfoLog(program_, sizeof(log), nullptr, log);
+        LOG_ERROR(std::string("Shader link error: ") + log);
+        glDeleteProgram(program_);
+        program_ = 0;
+        return false;
+    }
+
+    GLuint block = glGetUniformBlockIndex(program_, "Camera");
+    if (block != GL_INVALID_INDEX) glUniformBlockBinding(program_, block, kCameraBinding);
+    uColor_ = glGetUniformLocation(program_, "uColor");
+    uLit_ = glGetUniformLocation(program_, "uLit");
+    uHasTexture_ = glGetUniformLocation(program_, "uHasTexture");
+    uTexture_ = glGetUniformLocation(program_, "uTexture");
+
+    glUseProgram(program_);
+    glUniform1i(uTexture_, 0);
+    glUseProgram(0);
+    return true;
+}
+
+void Renderer::shutdown() {
+    ring_.shutdown();
+    MeshArena::instance().shutdown();
+    indirect_ = indirectSupported_ = false;
+    if (program_) { glDeleteProgram(program_); program_ = 0; }
+    backend_ = RenderBackend::Legacy;
+}
+
+void Renderer::beginFrame() {
+    stats_ = Stats();
+    if (isShader()) ring_.beginFrame();
+}
+
+void Renderer::endFrame() {
+    if (isShader()) ring_.endFrame();
+}
+
+void Renderer::beginPass(const mat4& view, const mat4& proj) {
+    view_ = view;
+    queue_.clear();
+    debugNormals_.clear();
+    for (auto& ranges : staticVisible_) ranges.clear();
+    selectionMarked_ = false;
+    if (staticBatcher_) staticVisible_.resize(staticBatcher_->batches().size());
+    if (!isShader()) return;
+
+    CameraBlock cam;
+    cam.view = glm::mat4(view);
+    cam.proj = glm::mat4(proj);
+    cam.viewProj = glm::mat4(proj * view);
+    cam.lightPosView = glm::vec4(5.0f, 10.0f, 5.0f, 1.0f);
+
+    RingBuffer::Slice slice = ring_.allocate(sizeof(CameraBlock), uboAlignment_);
+    if (!slice.data) return;
+    std::memcpy(slice.data, &cam, sizeof(CameraBlock));
+    ring_.commit(slice);
+    glBindBufferRange(GL_UNIFORM_BUFFER, kCameraBinding, slice.buffer, slice.offset, slice.size);
+}
+
+void Renderer::submit(const GameObject& go) {
+    const Mesh* mesh = go.mesh.get();
+    if (!mesh || mesh->VAO == 0) return;
+    ++stats_.submitted;
+
+    const vec3 center = go.worldAABB().center();
+    const float depth = (float)-(view_ * vec4(center, 1.0)).z;
+
+    RenderItem item;
+    item.object = &go;
+    item.mesh = mesh;
+    item.texture = go.getTextureID();
+    // De momento hay un solo programa: el campo de la clave queda a 0
+    const bool stencilSelected = go.isSelected && stencilSelection_;
+    if (go.isSelected && !stencilSelected) {
+        item.pass = RenderQueue::SelectionOutline;
+        queue_.push(item, RenderQueue::makeKey(item.pass, 0, 0, mesh->VAO, depth));
+    }
+    if (mesh->showVertexNormals || mesh->showFaceNormals) debugNormals_.push_back(&go);
+
+    // En un lote estatico: solo se apunta su rango, el contorno sigue en la cola.
+    // Con seleccion por stencil el seleccionado sale del lote para marcarlo
+    if (!stencilSelected && staticBatcher_ && go.staticBatchHandle != StaticBatcher::kNoBatch) {
+        const StaticBatcher::Range& r = staticBatcher_->range(go.staticBatchHandle);
+        if (r.batch < staticVisible_.size()) {
+            staticVisible_[r.batch].push_back({ r.firstIndex, r.indexCount });
+            return;
+        }
+    }
+    item.pass = stencilSelected ? RenderQueue::SelectedOpaque : RenderQueue::Opaque;
+    selectionMarked_ |= stencilSelected;
+    queue_.push(item, RenderQueue::makeKey(item.pass, 0, item.texture, mesh->VAO, depth));
+}
+
+void Renderer::endPass() {
+    bool anyStatic = false;
+    for (const auto& ranges : staticVisible_) anyStatic |= !ranges.empty();
+
+    if (isShader() && (!queue_.empty() || anyStatic)) {
+        glUseProgram(program_);
+        ++stats_.programBinds;
+    }
+    if (!queue_.empty()) {
+        queue_.sort();
+        if (isShader()) flushShader();
+        else flushLegacy();
+    }
+    // Despues de la cola: el contorno de seleccion tiene que ir antes que el relleno
+    if (anyStatic) drawStaticBatches();
+    drawDebugNormals();
+    if (isShader()) glUseProgram(0);
+    queue_.clear();
+}
+
+Renderer::InstanceData Renderer::makeInstance(const GameObject& object) {
+    const mat4& world = object.worldMatrix();
+    const glm::dmat3 normal = glm::transpose(glm::inverse(glm::dmat3(world)));
+    InstanceData inst;
+    inst.model = glm::mat4(world);
+    for (int c = 0; c < 3; ++c) inst.normal[c] = glm::vec4(glm::vec3(normal[c]), 0.0f);
+    return inst;
+}
+
+bool Renderer::uploadInstances() {
+    // Una matriz de modelo y una de normales por draw, en el orden de la cola,
+    // escritas directamente en el ring
+    RingBuffer::Slice slice = ring_.allocate(queue_.size() * sizeof(InstanceData), 16);
+    InstanceData* out = static_cast<InstanceData*>(slice.data);
+    if (!out) {
+        instanceBuffer_ = 0;
+        instanceBase_ = 0;
+        return false;
+    }
+    instanceBuffer_ = slice.buffer;
+    instanceBase_ = (size_t)slice.offset;
+    for (size_t i = 0; i < queue_.size(); ++i) out[i] = makeInstance(*queue_[i].object);
+    ring_.commit(slice);
+    return true;
+}
+
+void Renderer::bindInstanceAttribs(size_t first) {
+    // Sin base instance en 3.3: el primer elemento del lote va en el offset del puntero.
+    // Es estado del VAO, asi que se vuelve a apuntar en cada lote.
+    const GLsizei stride = sizeof(InstanceData);
+    const size_t base = instanceBase_ + first * sizeof(InstanceData);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer_);
+    for (GLuint c = 0; c < 4; ++c) {
+        const GLuint loc = kInstanceModelAttrib + c;
+        glEnableVertexAttribArray(loc);
+        glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, stride,
+            reinterpret_cast<const void*>(base + offsetof(InstanceData, model) + c * sizeof(glm::vec4)));
+        glVertexAttribDivisor(loc, 1);
+    }
+    for (GLuint c = 0; c < 3; ++c) {
+        const GLuint loc = kInstanceNormalAttrib + c;
+        glEnableVertexAttribArray(loc);
+        glVertexAttribPointer(loc, 3, GL_FLOAT, GL_FALSE, stride,
+            reinterpret_cast<const void*>(base + offsetof(InstanceData, normal) + c * sizeof(glm::vec4)));
+        glVertexAttribDivisor(loc, 1);
+    }
+}
+
+void Renderer::setInstanceConstant(const InstanceData& inst) {
+    // Sin buffer de instancias: la matriz va como atributo constante del vertex
+    // array, que es lo que lee el shader cuando el array esta desactivado
+    for (GLuint c = 0; c < 4; ++c) {
+        glDisableVertexAttribArray(kInstanceModelAttrib + c);
+        glVertexAttrib4fv(kInstanceModelAttrib + c, &inst.model[c][0]);
+    }
+    for (GLuint c = 0; c < 3; ++c) {
+        glDisableVertexAttribArray(kInstanceNormalAttrib + c);
+        glVertexAttrib3fv(kInstanceNormalAttrib + c, &inst.normal[c][0]);
+    }
+}
+
+size_t Renderer::runEnd(size_t i) const {
+    // Lote: draws seguidos con la misma pasada, textura y mesh. La cola ya
+    // los deja juntos porque esos campos van antes que la profundidad.
+    const RenderItem& item = queue_[i];
+    size_t end = i + 1;
+    while (end < queue_.size()) {
+        const RenderItem& next = queue_[end];
+        if (next.pass != item.pass || next.mesh != item.mesh) break;
+        if (passUsesTexture(item.pass) && next.texture != item.texture) break;
+        ++end;
+    }
+    return end;
+}
+
+void Renderer::applyShaderPass(int pass, GLuint boundTex) {
+    const bool outline = pass == RenderQueue::SelectionOutline;
+    // Alambre amarillo sin luz ni textura, como en flushLegacy
+    glPolygonMode(GL_FRONT_AND_BACK, outline ? GL_LINE : GL_FILL);
+    glLineWidth(outline ? 3.0f : 1.0f);
+    if (outline) glUniform4f(uColor_, 1.0f, 1.0f, 0.0f, 1.0f);
+    else glUniform4f(uColor_, 1.0f, 1.0f, 1.0f, 1.0f);
+    glUniform1i(uLit_, outline ? 0 : 1);
+    glUniform1i(uHasTexture_, boundTex != 0);
+
+    if (pass == RenderQueue::SelectedOpaque) {
+        glEnable(GL_STENCIL_TEST);
+        glStencilMask(0xFF);
+        glStencilFunc(GL_ALWAYS, 1, 0xFF);
+        glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+    }
+    else glDisable(GL_STENCIL_TEST);
+}
+
+void Renderer::bindShaderTexture(GLuint tex, GLuint& boundTex) {
+    if (tex != boundTex) {
+        if ((tex != 0) != (boundTex != 0)) glUniform1i(uHasTexture_, tex != 0);
+        glBindTexture(GL_TEXTURE_2D, tex);
+        boundTex = tex;
+        ++stats_.textureBinds;
+    }
+    else if (tex != 0) ++stats_.bindsSkipped;
+}
+
+void Renderer::flushShader() {
+    const bool instanced = uploadInstances();
+    glActiveTexture(GL_TEXTURE0);
+
+    int pass = -1;
+    GLuint boundTex = 0;
+    if (!instanced) flushPerDraw(pass, boundTex);
+    else if (indirect_) flushIndirect(pass, boundTex);
+    else flushDirect(pass, boundTex);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (boundTex) glBindTexture(GL_TEXTURE_2D, 0);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glLineWidth(1.0f);
+    glDisable(GL_STENCIL_TEST);
+}
+
+void Renderer::drawRun(size_t first, size_t end, int& pass, GLuint& boundTex, GLuint& boundVAO) {
+    const RenderItem& item = queue_[first];
+    if (item.pass != pass) {
+        pass = item.pass;
+        applyShaderPass(pass, boundTex);
+    }
+    bindShaderTexture(passUsesTexture(pass) ? item.texture : 0, boundTex);
+
+    if (item.mesh->VAO != boundVAO) {
+        boundVAO = item.mesh->VAO;
+        glBindVertexArray(boundVAO);
+        ++stats_.vaoBinds;
+    }
+    else ++stats_.bindsSkipped;
+
+    const GLsizei count = static_cast<GLsizei>(end - first);
+    bindInstanceAttribs(first);
+    item.mesh->drawBound(count);
+    ++stats_.drawCalls;
+    if (count > 1) {
+        ++stats_.instancedBatches;
+        stats_.instancedObjects += count;
+    }
+}
+
+void Renderer::flushDirect(int& pass, GLuint& boundTex) {
+    GLuint boundVAO = 0;
+    for (size_t i = 0; i < queue_.size();) {
+        const size_t end = runEnd(i);
+        drawRun(i, end, pass, boundTex, boundVAO);
+        i = end;
+    }
+}
+
+void Renderer::flushPerDraw(int& pass, GLuint& boundTex) {
+    // El ring no tiene sitio para las matrices: un draw por objeto con la
+    // matriz como atributo constante, sin instancing ni indirect
+    GLuint boundVAO = 0;
+    for (size_t i = 0; i < queue_.size(); ++i) {
+        const RenderItem& item = queue_[i];
+        if (item.pass != pass) {
+            pass = item.pass;
+            applyShaderPass(pass, boundTex);
+        }
+        bindShaderTexture(passUsesTexture(pass) ? item.texture : 0, boundTex);
+        if (item.mesh->VAO != boundVAO) {
+            boundVAO = item.mesh->VAO;
+            glBindVertexArray(boundVAO);
+            ++stats_.vaoBinds;
+        }
+        else ++stats_.bindsSkipped;
+        setInstanceConstant(makeInstance(*item.object));
+        item.mesh->drawBound(1);
+        ++stats_.drawCalls;
+    }
+}
+
+void Renderer::flushIndirect(int& pass, GLuint& boundTex) {
+    MeshArena& arena = MeshArena::instance();
+    commands_.clear();
+    buckets_.clear();
+    fallbackRuns_.clear();
+
+    // Un comando por tramo de instancias; un cubo por pasada y textura
+    for (size_t i = 0; i < queue_.size();) {
+        const size_t end = runEnd(i);
+        const RenderItem& item = queue_[i];
+        const MeshArena::Allocation* alloc = arena.acquire(*item.mesh);
+        if (!alloc) {
+            fallbackRuns_.push_back({ (uint32_t)i, (uint32_t)end });
+            i = end;
+            continue;
+        }
+        const GLuint tex = passUsesTexture(item.pass) ? item.texture : 0;
+        if (buckets_.empty() || buckets_.back().pass != item.pass || buckets_.back().texture != tex) {
+            IndirectBucket b;
+            b.pass = item.pass;
+            b.texture = tex;
+            b.firstCommand = (uint32_t)commands_.size();
+            buckets_.push_back(b);
+        }
+        DrawElementsIndirectCommand cmd;
+        cmd.count = alloc->indexCount;
+        cmd.instanceCount = (GLuint)(end - i);
+        cmd.firstIndex = alloc->firstIndex;
+        cmd.baseVertex = (GLint)alloc->baseVertex;
+        cmd.baseInstance = (GLuint)i; // Fila de uploadInstances
+        commands_.push_back(cmd);
+        ++buckets_.back().commandCount;
+        i = end;
+    }
+
+    if (!commands_.empty()) {
+        const size_t bytes = commands_.size() * sizeof(DrawElementsIndirectCommand);
+        RingBuffer::Slice slice = ring_.allocate(bytes, sizeof(GLuint));
+        if (!slice.data) {
+            // Sin sitio para los comandos: la cola entera por el camino directo
+            flushDirect(pass, boundTex);
+            return;
+        }
+        std::memcpy(slice.data, commands_.data(), bytes);
+        ring_.commit(slice);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, slice.buffer);
+
+        // Atributos de instancia desde la fila 0: baseInstance elige la del comando
+        glBindVertexArray(arena.vao());
+        ++stats_.vaoBinds;
+        bindInstanceAttribs(0);
+        for (const IndirectBucket& b : buckets_) {
+            if (b.pass != pass) {
+                pass = b.pass;
+                applyShaderPass(pass, boundTex);
+            }
+            bindShaderTexture(b.texture, boundTex);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                reinterpret_cast<const void*>(size_t(slice.offset) + size_t(b.firstCommand) * sizeof(DrawElementsIndirectCommand)),
+                (GLsizei)b.commandCount, 0);
+            ++stats_.drawCalls;
+            ++stats_.indirectDraws;
+            stats_.indirectCommands += (int)b.commandCount;
+        }
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    // Meshes que no caben en el arena (formato float): un draw por tramo
+    GLuint boundVAO = 0;
+    for (const auto& run : fallbackRuns_) drawRun(run.first, run.second, pass, boundTex, boundVAO);
+}
+
+void Renderer::flushLegacy() {
+    // El camino legacy tiñe los meshes con el color actual (GL_COLOR_MATERIAL);
+    // se guarda para que el amarillo del contorno no se quede en los siguientes
+    GLfloat color[4];
+    glGetFloatv(GL_CURRENT_COLOR, color);
+    glActiveTexture(GL_TEXTURE0);
+
+    int pass = -1;
+    GLuint boundTex = 0;
+    GLuint boundVAO = 0;
+    for (size_t i = 0; i < queue_.size(); ++i) {
+        const RenderItem& item = queue_[i];
+        if (item.pass != pass) {
+            pass = item.pass;
+            if (pass == RenderQueue::SelectionOutline) {
+                glDisable(GL_LIGHTING);
+                glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+                glLineWidth(3.0f);
+                glColor3f(1.0f, 1.0f, 0.0f);
+            }
+            else {
+                glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+                glLineWidth(1.0f);
+                glEnable(GL_LIGHTING);
+                glColor4fv(color);
+            }
+        }
+
+        const GLuint tex = pass == RenderQueue::Opaque ? item.texture : 0;
+        if (tex != boundTex) {
+            if (tex != 0 && boundTex == 0) glEnable(GL_TEXTURE_2D);
+            else if (tex == 0) glDisable(GL_TEXTURE_2D);
+            glBindTexture(GL_TEXTURE_2D, tex);
+            boundTex = tex;
+            ++stats_.textureBinds;
+        }
+        else if (tex != 0) ++stats_.bindsSkipped;
+
+        if (item.mesh->VAO != boundVAO) {
+            boundVAO = item.mesh->VAO;
+            glBindVertexArray(boundVAO);
+            ++stats_.vaoBinds;
+        }
+        else ++stats_.bindsSkipped;
+
+        glPushMatrix();
+        glMultMatrixd(glm::value_ptr(item.object->worldMatrix()));
+        item.mesh->drawBound();
+        glPopMatrix();
+        ++stats_.drawCalls;
+    }
+
+    glBindVertexArray(0);
+    if (boundTex) {
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glDisable(GL_TEXTURE_2D);
+    }
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glLineWidth(1.0f);
+    glEnable(GL_LIGHTING);
+    glColor4fv(color);
+}
+
+void Renderer::drawStaticBatches() {
+    const auto& batches = staticBatcher_->batches();
+    glActiveTexture(GL_TEXTURE0);
+    if (isShader()) {
+        // Los lotes ya estan en mundo: los atributos de instancia quedan
+        // deshabilitados en su VAO y se usa este valor constante (identidad)
+        for (GLuint c = 0; c < 4; ++c)
+            glVertexAttrib4f(kInstanceModelAttrib + c, c == 0, c == 1, c == 2, c == 3);
+        for (GLuint c = 0; c < 3; ++c)
+            glVertexAttrib3f(kInstanceNormalAttrib + c, c == 0, c == 1, c == 2);
+        glUniform4f(uColor_, 1.0f, 1.0f, 1.0f, 1.0f);
+        glUniform1i(uLit_, 1);
+    }
+
+    for (size_t b = 0; b < batches.size() && b < staticVisible_.size(); ++b) {
+        auto& ranges = staticVisible_[b];
+        if (ranges.empty()) continue;
+        stats_.staticObjects += (int)ranges.size();
+
+        // Rangos ordenados y fusionados: los objetos contiguos en el lote salen en un tramo
+        std::sort(ranges.begin(), ranges.end());
+        multiCounts_.clear();
+        multiOffsets_.clear();
+        uint32_t first = ranges[0].first, end = ranges[0].first + ranges[0].second;
+        for (size_t i = 1; i <= ranges.size(); ++i) {
+            if (i < ranges.size() && ranges[i].first == end) {
+                end += ranges[i].second;
+                continue;
+            }
+            multiCounts_.push_back((GLsizei)(end - first));
+            multiOffsets_.push_back(reinterpret_cast<const void*>(size_t(first) * sizeof(unsigned int)));
+            if (i < ranges.size()) {
+                first = ranges[i].first;
+                end = first + ranges[i].second;
+            }
+        }
+
+        const StaticBatcher::Batch& batch = batches[b];
+        if (isShader()) glUniform1i(uHasTexture_, batch.texture != 0);
+        else if (batch.texture) glEnable(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, batch.texture);
+        glBindVertexArray(batch.VAO);
+        ++stats_.vaoBinds;
+        if (batch.texture) ++stats_.textureBinds;
+
+        glMultiDrawElements(GL_TRIANGLES, multiCounts_.data(), GL_UNSIGNED_INT,
+            multiOffsets_.data(), (GLsizei)multiCounts_.size());
+        ++stats_.drawCalls;
+        ++stats_.staticDraws;
+
+        if (!isShader() && batch.texture) glDisable(GL_TEXTURE_2D);
+    }
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void Renderer::drawDebugNormals() {
+    // Se acumulan en DebugDraw, que las pinta al final de la pasada
+    for (const GameObject* go : debugNormals_) go->mesh->drawNormals(go->worldMatrix());
+}
@@ -0,0 +1,160 @@
+#pragma once
+#include "types.h"
+#include <GL/glew.h>
+#include "RenderQueue.h"
+#include "RingBuffer.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+class GameObject;
+class StaticBatcher;
+
+enum class RenderBackend {
+    Legacy, // Pipeline fijo de GL 2.1 (glPushMatrix, glVertexPointer, GL_LIGHTING)
+    Shader  // GLSL 3.3: UBO de camara por pasada y matriz de modelo por draw
+};
+
+// Camino de render con shaders. Los draws seguidos de la cola que comparten
+// mesh y textura se pintan con una sola llamada instanciada. Se elige al arrancar; si no hay contexto 3.3
+// o los shaders no compilan, el motor sigue con el camino legacy.
+// Los gizmos de debug siguen en modo inmediato, por eso el contexto 3.3 se
+// pide con perfil de compatibilidad y los shaders son "#version 330 core".
+class Renderer {
+public:
+    static Renderer& instance();
+
+    // Llamar con el contexto ya creado y GLEW inicializado
+    bool init(RenderBackend requested);
+    void shutdown();
+
+    RenderBackend backend() const { return backend_; }
+    bool isShader() const { return backend_ == RenderBackend::Shader; }
+    const char* backendName() const;
+
+    // Contadores de la frame actual, para el panel de Config
+    struct Stats {
+        int submitted = 0;    // Objetos enviados a la cola
+        int drawCalls = 0;
+        int programBinds = 0;
+        int textureBinds = 0;
+        int vaoBinds = 0;
+        int bindsSkipped = 0; // Binds de textura/VAO ahorrados por el orden de la cola
+        int instancedBatches = 0; // Draw calls que pintan mas de un objeto
+        int instancedObjects = 0; // Objetos pintados dentro de esos lotes
+        int staticDraws = 0;      // Draw calls de lotes estaticos
+        int staticObjects = 0;    // Objetos visibles pintados desde esos lotes
+        int indirectDraws = 0;    // glMultiDrawElementsIndirect emitidos
+        int indirectCommands = 0; // Comandos dentro de esas llamadas
+    };
+    // Abren y cierran la frame del ring de datos dinamicos (una vez por frame,
+    // alrededor de todas las pasadas)
+    void beginFrame();
+    void endFrame();
+    const RingBuffer& ring() const { return ring_; }
+    RingBuffer& ring() { return ring_; }
+
+    // Multi-draw indirect: todos los meshes en MeshArena y una llamada por
+    // pasada y textura. Requiere GL 4.3 (o sus extensiones) en el contexto.
+    bool indirectSupported() const { return indirectSupported_; }
+    bool isIndirectEnabled() const { return indirect_; }
+    void setIndirectEnabled(bool enabled) { indirect_ = enabled && indirectSupported_; }
+
+    // Seleccion por stencil: el seleccionado se pinta relleno escribiendo
+    // stencil = 1 y sin la pasada de alambre; el contorno lo pone OutlinePass
+    void setStencilSelection(bool enabled) { stencilSelection_ = enabled && isShader(); }
+    // La ultima pasada marco algun objeto en el stencil
+    bool selectionInLastPass() const { return selectionMarked_; }
+
+    // Los objetos con rango en estos lotes se pintan desde ahi, no desde la cola
+    void setStaticBatcher(const StaticBatcher* batcher) { staticBatcher_ = batcher; }
+    const Stats& stats() const { return stats_; }
+
+    // Empieza una pasada: con shaders sube el UBO de camara. En legacy las
+    // matrices de camara ya tienen que estar cargadas en la pila de GL.
+    void beginPass(const mat4& view, const mat4& proj);
+    void submit(const GameObject& go);
+    // Ordena la cola y la dibuja saltandose los cambios de estado repetidos.
+    // Deja el programa 0 para que los gizmos en modo inmediato sigan funcionando.
+    void endPass();
+
+private:
+    Renderer() = default;
+    Renderer(const Renderer&) = delete;
+    Renderer& operator=(const Renderer&) = delete;
+
+    bool buildProgram();
+    bool uploadInstances();
+    void bindInstanceAttribs(size_t first);
+    size_t runEnd(size_t first) const;
+    void applyShaderPass(int pass, GLuint boundTex);
+    void bindShaderTexture(GLuint tex, GLuint& boundTex);
+    void drawRun(size_t first, size_t end, int& pass, GLuint& boundTex, GLuint& boundVAO);
+    void flushShader();
+    void flushDirect(int& pass, GLuint& boundTex);
+    void flushPerDraw(int& pass, GLuint& boundTex);
+    void flushIndirect(int& pass, GLuint& boundTex);
+    void flushLegacy();
+    void drawStaticBatches();
+    void drawDebugNormals();
+
+    // Atributos por instancia (divisor 1). Columnas de la matriz de normales en
+    // vec4 para que el stride quede alineado; el shader lee solo xyz.
+    struct InstanceData {
+        glm::mat4 model;
+        glm::vec4 normal[3];
+    };
+    static InstanceData makeInstance(const GameObject& object);
+    void setInstanceConstant(const InstanceData& inst);
+
+    // Layout fijo de GL para glMultiDrawElementsIndirect
+    struct DrawElementsIndirectCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint  baseVertex;
+        GLuint baseInstance;
+    };
+    struct IndirectBucket {
+        int pass = 0;
+        GLuint texture = 0;
+        uint32_t firstCommand = 0;
+        uint32_t commandCount = 0;
+    };
+
+    // Bloque std140 "Camera" del shader
+    struct CameraBlock {
+        glm::mat4 view;
+        glm::mat4 proj;
+        glm::mat4 viewProj;
+        glm::vec4 lightPosView; // Como GL_LIGHT0 legacy: fija respecto a la camara
+    };
+
+    RenderBackend backend_ = RenderBackend::Legacy;
+    RenderQueue queue_;
+    const StaticBatcher* staticBatcher_ = nullptr;
+    // Rangos visibles de cada lote estatico en esta pasada: (primer indice, cantidad)
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> staticVisible_;
+    std::vector<GLsizei> multiCounts_;
+    std::vector<const void*> multiOffsets_;
+    std::vector<const GameObject*> debugNormals_;
+    Stats stats_;
+    mat4 view_ = mat4(1.0);
+    GLuint program_ = 0;
+    RingBuffer ring_;
+    size_t uboAlignment_ = 256;
+    GLuint instanceBuffer_ = 0; // Slice del ring con las instancias de la pasada
+    size_t instanceBase_ = 0;
+    bool stencilSelection_ = false;
+    bool selectionMarked_ = false;
+    bool indirectSupported_ = false;
+    bool indirect_ = false;
+    std::vector<DrawElementsIndirectCommand> commands_;
+    std::vector<IndirectBucket> buckets_;
+    std::vector<std::pair<uint32_t, uint32_t>> fallbackRuns_; // [inicio, fin) en la cola
+    GLint uColor_ = -1;
+    GLint uLit_ = -1;
+    GLint uHasTexture_ = -1;
+    GLint uTexture_ = -1;
+};
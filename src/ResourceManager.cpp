@@ -0,0 +1,136 @@
+#include "ResourceManager.h"
+#include "AssetDatabase.h"
+#include "ModelLoader.h"
+#include "Logger.h"
+#include <algorithm>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+ResourceManager& ResourceManager::instance() {
+    static ResourceManager inst;
+    return inst;
+}
+
+std::string ResourceManager::keyFor(const std::string& path, std::string& guid, uint64_t& importKey) const {
+    AssetDatabase& db = AssetDatabase::instance();
+    if (AssetMeta* meta = db.findAssetForFile(path)) {
+        guid = meta->guid;
+        // Sin rehashear el fuente en el hilo principal: vale el hash del ultimo refresh
+        importKey = AssetDatabase::cachedImportKey(*meta);
+        return guid;
+    }
+    guid.clear();
+    importKey = 0;
+    std::error_code ec;
+    const fs::path canonical = fs::weakly_canonical(fs::path(path), ec);
+    return ec ? path : canonical.string();
+}
+
+template <typename T>
+std::shared_ptr<T> ResourceManager::makeReference(const std::shared_ptr<Entry>& entry, std::shared_ptr<T> resource) {
+    ++entry->references;
+    if (!entry->guid.empty()) AssetDatabase::instance().incrementReference(entry->guid);
+    // Bloque de control propio: el deleter no borra nada, solo descuenta. El
+    // recurso sigue vivo mientras quede alguna copia de esta referencia
+    T* raw = resource.get();
+    return std::shared_ptr<T>(raw, [entry, resource](T*) {
+        ResourceManager::instance().release(*entry);
+    });
+}
+
+void ResourceManager::release(Entry& entry) {
+    if (shutdown_) return;
+    --entry.references;
+    if (!entry.guid.empty()) AssetDatabase::instance().decrementReference(entry.guid);
+}
+
+std::shared_ptr<ModelHandle> ResourceManager::loadModel(const std::string& path) {
+    std::string guid;
+    uint64_t importKey = 0;
+    const std::string key = keyFor(path, guid, importKey);
+    auto it = models_.find(key);
+    if (it != models_.end()) {
+        if (it->second->importKey == importKey) return it->second->model;
+        // Ajustes o fuente cambiados: la entrada vieja sale de la cache, pero sus
+        // referencias la mantienen viva (y contada) hasta que se suelten
+        LOG_INFO("Import settings changed, reloading model: " + path);
+        staleModels_.push_back(std::move(it->second));
+        models_.erase(it);
+    }
+
+    auto entry = std::make_shared<Entry>();
+    entry->guid = guid;
+    entry->importKey = importKey;
+    entry->model = AsyncModelLoader::instance().load(path);
+    models_[key] = entry;
+    return entry->model;
+}
+
+std::shared_ptr<Mesh> ResourceManager::acquireMesh(const ModelHandle& model, size_t index) {
+    if (index >= model.meshes().size()) return nullptr;
+    for (auto& kv : models_) {
+        if (kv.second->model.get() == &model) return makeReference(kv.second, model.meshes()[index]);
+    }
+    for (auto& entry : staleModels_) {
+        if (entry->model.get() == &model) return makeReference(entry, model.meshes()[index]);
+    }
+    // Handle que no salio de loadModel: sin contar
+    return model.meshes()[index];
+}
+
+std::shared_ptr<TextureResource> ResourceManager::acquireTexture(const std::string& path) {
+    return acquireTexture(path, nullptr);
+}
+
+std::shared_ptr<TextureResource> ResourceManager::acquireTexture(const DecodedTexture& decoded) {
+    return acquireTexture(decoded.path, &decoded);
+}
+
+std::shared_ptr<TextureResource> ResourceManager::acquireTexture(const std::string& path, const DecodedTexture* decoded) {
+    std::string guid;
+    uint64_t importKey = 0;
+    const std::string key = keyFor(path, guid, importKey);
+    auto it = textures_.find(key);
+    if (it != textures_.end() && it->second->importKey != importKey) {
+        textures_.erase(it);
+        it = textures_.end();
+    }
+    if (it == textures_.end()) {
+        const GLuint id = decoded ? UploadTexture2D(*decoded) : LoadTexture2D(path);
+        if (!id) return nullptr;
+        auto entry = std::make_shared<Entry>();
+        entry->guid = guid;
+        entry->importKey = importKey;
+        entry->texture = std::make_shared<TextureResource>();
+        entry->texture->id = id;
+        it = textures_.emplace(key, entry).first;
+    }
+    return makeReference(it->second, it->second->texture);
+}
+
+void ResourceManager::collect() {
+    for (auto it = models_.begin(); it != models_.end();) {
+        // Una carga en curso todavia tiene quien la espere
+        const Entry& e = *it->second;
+        if (e.references <= 0 && e.model->isDone()) {
+            LOG_INFO("Evicted model: " + e.model->path());
+            it = models_.erase(it);
+        }
+        else ++it;
+    }
+    staleModels_.erase(std::remove_if(staleModels_.begin(), staleModels_.end(), [](const std::shared_ptr<Entry>& e) {
+        return e->references <= 0 && e->model->isDone();
+    }), staleModels_.end());
+    for (auto it = textures_.begin(); it != textures_.end();) {
+        if (it->second->references <= 0) it = textures_.erase(it);
+        else ++it;
+    }
+}
+
+void ResourceManager::shutdown() {
+    shutdown_ = true;
+    models_.clear();
+    staleModels_.clear();
+    textures_.clear();
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "AsyncModelLoader.h"
+#include "TextureLoader.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Cache central de modelos y texturas, por GUID del AssetDatabase (o por ruta si
+// el fichero no es un asset). Cada acquire devuelve una referencia contada: sus
+// copias cuentan como una sola y al destruirse la ultima se descuenta. El total
+// de referencias de cada recurso es AssetMeta::referenceCount; al llegar a cero
+// el recurso se desaloja en collect() y con el sus buffers y texturas de GL.
+class ResourceManager {
+public:
+    static ResourceManager& instance();
+
+    // Carga compartida del modelo: si ya esta cargado o cargandose, el mismo handle.
+    // Si la clave de importacion del asset cambio (Scale, ejes, fuente nuevo) se
+    // carga de nuevo; los objetos con la version vieja la conservan hasta soltarla
+    std::shared_ptr<ModelHandle> loadModel(const std::string& path);
+    // Referencia al sub-mesh index de un handle de loadModel ya terminado
+    std::shared_ptr<Mesh> acquireMesh(const ModelHandle& model, size_t index);
+    // Carga la textura la primera vez (sincrono, DevIL); nullptr si falla
+    std::shared_ptr<TextureResource> acquireTexture(const std::string& path);
+    // Igual, con la imagen ya decodificada en un worker (decoded.path): solo
+    // sube a GL si la textura no estaba cargada
+    std::shared_ptr<TextureResource> acquireTexture(const DecodedTexture& decoded);
+
+    // Una vez por frame: desaloja lo que se ha quedado sin referencias. Se hace
+    // al final del frame y no al soltar la ultima, para que recargar la escena
+    // (Stop) reutilice los meshes en vez de volver a leerlos
+    void collect();
+    void shutdown();
+
+    size_t modelCount() const { return models_.size(); }
+    size_t textureCount() const { return textures_.size(); }
+
+private:
+    ResourceManager() = default;
+    ResourceManager(const ResourceManager&) = delete;
+    ResourceManager& operator=(const ResourceManager&) = delete;
+
+    struct Entry {
+        std::string guid;     // Vacio si no es un asset
+        uint64_t importKey = 0; // AssetDatabase::importKey al cargar; 0 si no es un asset
+        int references = 0;
+        std::shared_ptr<ModelHandle> model;      // Modelos: dueno de los Mesh
+        std::shared_ptr<TextureResource> texture; // Texturas
+    };
+
+    std::string keyFor(const std::string& path, std::string& guid, uint64_t& importKey) const;
+    std::shared_ptr<TextureResource> acquireTexture(const std::string& path, const DecodedTexture* decoded);
+    template <typename T>
+    std::shared_ptr<T> makeReference(const std::shared_ptr<Entry>& entry, std::shared_ptr<T> resource);
+    void release(Entry& entry);
+
+    std::unordered_map<std::string, std::shared_ptr<Entry>> models_;
+    std::unordered_map<std::string, std::shared_ptr<Entry>> textures_;
+    // Modelos sustituidos por una clave nueva: siguen repartiendo meshes a sus
+    // cargas pendientes hasta que collect() los suelta
+    std::vector<std::shared_ptr<Entry>> staleModels_;
+    bool shutdown_ = false;
+};
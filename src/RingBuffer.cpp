@@ -0,0 +1,161 @@
+#include "RingBuffer.h"
+#include "Logger.h"
+#include <string>
+
+static size_t alignUp(size_t value, size_t alignment) {
+    return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+}
+
+bool RingBuffer::init(size_t frameBytes) {
+    shutdown();
+    persistent_ = GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+    create(frameBytes);
+    if (!buffer_) return false;
+    LOG_INFO(std::string("Ring buffer: ") + (persistent_ ? "persistent mapped" : "orphaned")
+        + ", " + std::to_string(frameBytes / 1024) + " KB per frame");
+    return true;
+}
+
+void RingBuffer::create(size_t frameBytes) {
+    frameBytes_ = frameBytes;
+    glGenBuffers(1, &buffer_);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+    if (persistent_) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        const GLsizeiptr total = static_cast<GLsizeiptr>(frameBytes_ * kFramesInFlight);
+        glBufferStorage(GL_COPY_WRITE_BUFFER, total, nullptr, flags);
+        mapped_ = static_cast<uint8_t*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, total, flags));
+        if (!mapped_) {
+            LOG_WARN("Ring buffer: persistent map failed, falling back to orphaning");
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            glDeleteBuffers(1, &buffer_);
+            persistent_ = false;
+            glGenBuffers(1, &buffer_);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+        }
+    }
+    if (!persistent_)
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(frameBytes_), nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    head_ = regionStart();
+}
+
+void RingBuffer::deleteFences() {
+    for (GLsync& f : fences_) {
+        if (f) glDeleteSync(f);
+        f = nullptr;
+    }
+}
+
+void RingBuffer::deleteBuffer(GLuint buffer, uint8_t* mapped) {
+    if (!buffer) return;
+    if (mapped) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+    glDeleteBuffers(1, &buffer);
+}
+
+void RingBuffer::destroy() {
+    deleteFences();
+    deleteBuffer(buffer_, mapped_);
+    buffer_ = 0;
+    mapped_ = nullptr;
+}
+
+void RingBuffer::releaseRetired() {
+    // Los draws ya enviados que lo leen no se ven afectados: GL libera la
+    // memoria cuando la GPU termina con ellos
+    for (const Retired& r : retired_) deleteBuffer(r.buffer, r.mapped);
+    retired_.clear();
+}
+
+void RingBuffer::shutdown() {
+    releaseRetired();
+    destroy();
+    frameBytes_ = 0;
+    head_ = 0;
+    frame_ = 0;
+}
+
+void RingBuffer::beginFrame() {
+    if (!buffer_) return;
+    waits_ = 0;
+    if (persistent_) {
+        frame_ = (frame_ + 1) % kFramesInFlight;
+        if (GLsync& fence = fences_[frame_]) {
+            // Normalmente ya esta señalado: la GPU va como mucho dos frames por detras
+            GLenum r = glClientWaitSync(fence, 0, 0);
+            if (r == GL_TIMEOUT_EXPIRED) {
+                ++waits_;
+                do r = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+                while (r == GL_TIMEOUT_EXPIRED);
+            }
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    else {
+        // Huerfanar: el driver da memoria nueva si la anterior sigue en uso
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(frameBytes_), nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+    head_ = regionStart();
+}
+
+void RingBuffer::endFrame() {
+    releaseRetired();
+    if (!buffer_ || !persistent_) return;
+    if (fences_[frame_]) glDeleteSync(fences_[frame_]);
+    fences_[frame_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+RingBuffer::Slice RingBuffer::allocate(size_t bytes, size_t alignment) {
+    Slice slice;
+    if (!buffer_ || bytes == 0) return slice;
+
+    size_t offset = alignUp(head_, alignment);
+    if (offset + bytes > regionStart() + frameBytes_) {
+        // No cabe: buffer nuevo con el doble de region. Los fences del viejo
+        // ya no protegen nada del nuevo, que empieza sin usar. El viejo no se
+        // borra aqui: la pasada en curso aun tiene enlazados rangos suyos
+        size_t grown = frameBytes_ * 2;
+        while (grown < bytes + alignment) grown *= 2;
+        const int frame = frame_;
+        deleteFences();
+        retired_.push_back({ buffer_, mapped_ });
+        buffer_ = 0;
+        mapped_ = nullptr;
+        create(grown);
+        frame_ = frame;
+        head_ = regionStart();
+        offset = alignUp(head_, alignment);
+        LOG_INFO("Ring buffer grown to " + std::to_string(grown / 1024) + " KB per frame");
+    }
+    head_ = offset + bytes;
+
+    slice.buffer = buffer_;
+    slice.offset = static_cast<GLintptr>(offset);
+    slice.size = static_cast<GLsizeiptr>(bytes);
+    if (persistent_) {
+        slice.data = mapped_ + offset;
+    }
+    else {
+        // Las reservas del frame no se solapan: se puede mapear sin sincronizar
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+        slice.data = glMapBufferRange(GL_COPY_WRITE_BUFFER, slice.offset, slice.size,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+    return slice;
+}
+
+void RingBuffer::commit(const Slice& slice) {
+    // Persistente y coherente: lo escrito ya es visible para la GPU
+    if (persistent_ || !slice.data) return;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, slice.buffer);
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
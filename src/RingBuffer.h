@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <GL/glew.h>
+
+// Buffer de subida para datos que cambian cada frame (instancias, comandos
+// indirect, uniforms, geometria de debug). Tres regiones, una por frame en
+// vuelo: la CPU escribe en la region N mientras la GPU lee las anteriores, y
+// un fence por region evita pisar datos que la GPU aun no ha consumido.
+//
+// Con GL 4.4 / ARB_buffer_storage el buffer se mapea una sola vez
+// (persistente y coherente). En 3.3 se huerfana al empezar cada frame y cada
+// reserva se mapea sin sincronizar; el driver se encarga de no esperar.
+class RingBuffer {
+public:
+    static constexpr int kFramesInFlight = 3;
+
+    // Trozo reservado en el frame actual. Escribir en data y llamar a commit()
+    // antes de la siguiente reserva y antes de usarlo en una draw call.
+    struct Slice {
+        void* data = nullptr;
+        GLuint buffer = 0;
+        GLintptr offset = 0;
+        GLsizeiptr size = 0;
+    };
+
+    bool init(size_t frameBytes);
+    void shutdown();
+
+    // Pasa a la siguiente region, esperando su fence si la GPU aun la usa
+    void beginFrame();
+    // Pone el fence de la region del frame que acaba
+    void endFrame();
+
+    // Si no cabe en la region, el buffer crece (buffer nuevo). El anterior se
+    // retira hasta endFrame: lo ya enlazado en la pasada (el bloque de camara,
+    // slices ya escritos) sigue siendo valido hasta el final del frame
+    Slice allocate(size_t bytes, size_t alignment);
+    void commit(const Slice& slice);
+
+    bool isPersistent() const { return persistent_; }
+    size_t frameBytes() const { return frameBytes_; }
+    size_t usedThisFrame() const { return head_ - regionStart(); }
+    int lastFrameWaits() const { return waits_; } // Frames en los que hubo que esperar al fence
+
+private:
+    struct Retired {
+        GLuint buffer = 0;
+        uint8_t* mapped = nullptr;
+    };
+
+    void create(size_t frameBytes);
+    void destroy();
+    void deleteFences();
+    static void deleteBuffer(GLuint buffer, uint8_t* mapped);
+    void releaseRetired();
+    size_t regionStart() const { return persistent_ ? size_t(frame_) * frameBytes_ : 0; }
+
+    GLuint buffer_ = 0;
+    uint8_t* mapped_ = nullptr;
+    bool persistent_ = false;
+    size_t frameBytes_ = 0;
+    size_t head_ = 0;
+    int frame_ = 0;
+    int waits_ = 0;
+    GLsync fences_[kFramesInFlight] = {};
+    std::vector<Retired> retired_; // Buffers sustituidos al crecer este frame
+};
@@ -3,6 +3,9 @@
 #include <iostream>
 #include <sstream>
 #include "ModelLoader.h"
+#include "ResourceManager.h"
+#include "Octree.h"
+#include <algorithm>
 #include "TextureLoader.h"
 #include <filesystem>
 
@@ -41,6 +44,7 @@ void SceneSerializer::SaveScene(const std::string& filepath, const std::vector<s
         out << "Position: " << translation.x << " " << translation.y << " " << translation.z << "\n";
         out << "Rotation: " << euler.x << " " << euler.y << " " << euler.z << "\n";
         out << "Scale: " << scale.x << " " << scale.y << " " << scale.z << "\n";
+        if (go->isStatic) out << "Static: true\n";
         
         // [NEW] Serialize Mesh Info
         if (!go->modelPath.empty()) {
@@ -75,7 +79,7 @@ void SceneSerializer::SaveScene(const std::string& filepath, const std::vector<s
     out.close();
 }
 
-void SceneSerializer::LoadScene(const std::string& filepath, std::vector<std::shared_ptr<GameObject>>& scene) {
+void SceneSerializer::LoadScene(const std::string& filepath, std::vector<std::shared_ptr<GameObject>>& scene, Octree* octree) {
     std::ifstream in(filepath);
     if (!in.is_open()) return;
 
@@ -125,6 +129,9 @@ void SceneSerializer::LoadScene(const std::string& filepath, std::vector<std::sh
             if(currentGO) currentGO->transform.setScale(loadedScale);
         }
 
+        else if (line.find("Static: ") == 0) {
+            if(currentGO) currentGO->isStatic = true;
+        }
         else if (line.find("ModelPath: ") == 0) {
             if(currentGO) currentGO->modelPath = line.substr(11);
         }
@@ -165,7 +172,9 @@ void SceneSerializer::LoadScene(const std::string& filepath, std::vector<std::sh
         return "Assets"; // Fallback
     };
     std::string assetsDir = findAssetsPath();
-    std::unordered_map<std::string, std::vector<std::shared_ptr<Mesh>>> modelCache;
+    // Handles de los modelos de esta escena. La cache de verdad es el ResourceManager:
+    // al recargar (Stop) los meshes que ya estaban cargados se reutilizan
+    std::unordered_map<std::string, std::shared_ptr<ModelHandle>> modelCache;
 
     for (size_t i = 0; i < objects.size(); ++i) {
         auto go = objects[i].go;
@@ -184,19 +193,27 @@ void SceneSerializer::LoadScene(const std::string& filepath, std::vector<std::sh
                      std::cerr << "[SceneSerializer] ERROR: Model file not found: " << fullPath.string() << std::endl;
                      // Try absolute just in case it was stored absolute? No, main stores filename.
                 } else {
-                    auto meshes = ModelLoader::loadModel(fullPath.string()); 
-                    modelCache[go->modelPath] = meshes;
+                    modelCache[go->modelPath] = ResourceManager::instance().loadModel(fullPath.string());
                 }
             }
             
-            // Assign mesh if loaded
+            // Assign mesh when loaded
             if (modelCache.find(go->modelPath) != modelCache.end()) {
-                const auto& meshes = modelCache[go->modelPath];
-                if (go->meshIndex < (int)meshes.size()) {
-                    go->setMesh(meshes[go->meshIndex]);
-                } else {
-                    std::cerr << "[SceneSerializer] ERROR: Mesh index " << go->meshIndex << " out of bounds for " << go->modelPath << std::endl;
-                }
+                go->meshLoading = true;
+                std::weak_ptr<GameObject> weak = go;
+                modelCache[go->modelPath]->then([weak, &scene, octree](const ModelHandle& h) {
+                    auto obj = weak.lock();
+                    // La escena se ha vuelto a cargar mientras tanto
+                    if (!obj || std::find(scene.begin(), scene.end(), obj) == scene.end()) return;
+                    obj->meshLoading = false;
+                    const auto& meshes = h.meshes();
+                    if (obj->meshIndex < (int)meshes.size()) {
+                        obj->setMesh(ResourceManager::instance().acquireMesh(h, obj->meshIndex));
+                        if (octree) octree->insert(obj);
+                    } else {
+                        std::cerr << "[SceneSerializer] ERROR: Mesh index " << obj->meshIndex << " out of bounds for " << obj->modelPath << std::endl;
+                    }
+                });
             }
         }
 
@@ -4,8 +4,13 @@
 #include <string>
 #include "GameObject.h"
 
+class Octree;
+
 class SceneSerializer {
 public:
     static void SaveScene(const std::string& filepath, const std::vector<std::shared_ptr<GameObject>>& scene);
-    static void LoadScene(const std::string& filepath, std::vector<std::shared_ptr<GameObject>>& scene);
+    // Los modelos se cargan en segundo plano (AsyncModelLoader): los objetos entran
+    // sin mesh y lo reciben en frames posteriores; entonces se meten en octree, si se
+    // da. scene tiene que seguir vivo hasta que terminen las cargas
+    static void LoadScene(const std::string& filepath, std::vector<std::shared_ptr<GameObject>>& scene, Octree* octree = nullptr);
 };
@@ -0,0 +1,168 @@
+#include "StaticBatcher.h"
+#include <algorithm>
+
+bool StaticBatcher::isBatchable(const GameObject& go) {
+    return go.isStatic && go.mesh && go.mesh->VAO != 0 && go.mesh->getVertexCount() > 0;
+}
+
+bool StaticBatcher::structureChanged(const std::vector<std::shared_ptr<GameObject>>& scene) const {
+    size_t n = 0;
+    for (const auto& sp : scene) {
+        const GameObject& go = *sp;
+        if (!isBatchable(go)) {
+            // Un objeto que deja de ser estatico tiene que salir de su lote
+            if (go.staticBatchHandle != kNoBatch) return true;
+            continue;
+        }
+        if (n >= objects_.size()) return true;
+        const Entry& e = objects_[n++];
+        if (e.object != &go || e.mesh != go.mesh.get() || e.texture != go.getTextureID())
+            return true;
+    }
+    return n != objects_.size();
+}
+
+void StaticBatcher::sync(const std::vector<std::shared_ptr<GameObject>>& scene) {
+    if (structureChanged(scene)) {
+        rebuild(scene);
+        return;
+    }
+
+    // Mismos objetos en los mismos lotes: solo se rehacen los lotes con alguna
+    // matriz de mundo distinta. Rangos y cantidades no cambian
+    std::vector<bool> dirty;
+    for (Entry& e : objects_) {
+        if (e.worldStamp == e.object->worldStamp()) continue;
+        e.worldStamp = e.object->worldStamp();
+        const mat4& world = e.object->worldMatrix();
+        if (world == e.world) continue;
+        e.world = world;
+        if (dirty.empty()) dirty.resize(batches_.size(), false);
+        dirty[e.batch] = true;
+    }
+    for (size_t b = 0; b < dirty.size(); ++b) {
+        if (!dirty[b]) continue;
+        releaseBatch(batches_[b]);
+        uploadBatch(batches_[b]);
+    }
+}
+
+void StaticBatcher::releaseBatch(Batch& b) {
+    if (b.EBO) glDeleteBuffers(1, &b.EBO);
+    if (b.VBO) glDeleteBuffers(1, &b.VBO);
+    if (b.VAO) glDeleteVertexArrays(1, &b.VAO);
+    b.EBO = b.VBO = b.VAO = 0;
+    b.gpuBytes = 0;
+}
+
+void StaticBatcher::releaseBatches() {
+    for (Batch& b : batches_) releaseBatch(b);
+    batches_.clear();
+}
+
+void StaticBatcher::clear() {
+    releaseBatches();
+    for (auto& go : owners_) go->staticBatchHandle = kNoBatch;
+    owners_.clear();
+    objects_.clear();
+    ranges_.clear();
+}
+
+void StaticBatcher::rebuild(const std::vector<std::shared_ptr<GameObject>>& scene) {
+    clear();
+
+    // Orden estable por textura: los objetos de cada lote quedan en el orden de
+    // la escena, y objects_ conserva el orden de la escena para structureChanged()
+    std::vector<size_t> candidates;
+    for (const auto& sp : scene) {
+        if (!isBatchable(*sp)) continue;
+        owners_.push_back(sp);
+        Entry e;
+        e.object = sp.get();
+        e.mesh = sp->mesh.get();
+        e.texture = sp->getTextureID();
+        e.worldStamp = sp->worldStamp();
+        e.world = sp->worldMatrix();
+        candidates.push_back(objects_.size());
+        objects_.push_back(e);
+    }
+    if (candidates.empty()) return;
+
+    std::stable_sort(candidates.begin(), candidates.end(), [this](size_t a, size_t b) {
+        return objects_[a].texture < objects_[b].texture;
+    });
+
+    // Reparto en lotes y rangos de indices; los vertices los genera uploadBatch
+    Batch current;
+    size_t currentVertices = 0;
+    uint32_t currentIndices = 0;
+    ranges_.reserve(candidates.size());
+    for (size_t c : candidates) {
+        Entry& e = objects_[c];
+        const Mesh& mesh = *e.mesh;
+        if (!current.members.empty() && (e.texture != current.texture || currentVertices + mesh.getVertexCount() > kMaxBatchVertices)) {
+            batches_.push_back(std::move(current));
+            current = Batch();
+            currentVertices = 0;
+            currentIndices = 0;
+        }
+        current.texture = e.texture;
+
+        Range r;
+        r.batch = (uint32_t)batches_.size();
+        r.firstIndex = currentIndices;
+        r.indexCount = (uint32_t)(mesh.getIndexCount() == 0 ? mesh.getVertexCount() : mesh.getIndexCount());
+        currentVertices += mesh.getVertexCount();
+        currentIndices += r.indexCount;
+
+        e.batch = r.batch;
+        e.object->staticBatchHandle = (uint32_t)ranges_.size();
+        ranges_.push_back(r);
+        current.members.push_back(e.object);
+    }
+    batches_.push_back(std::move(current));
+
+    for (Batch& b : batches_) uploadBatch(b);
+}
+
+void StaticBatcher::uploadBatch(Batch& batch) {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    for (GameObject* go : batch.members) {
+        const Mesh& mesh = *go->mesh;
+        // Transformacion de mundo aplicada a los vertices; normales con la inversa traspuesta
+        const mat4& world = go->worldMatrix();
+        const glm::dmat3 normalMatrix = glm::transpose(glm::inverse(glm::dmat3(world)));
+        const uint32_t base = (uint32_t)vertices.size();
+        for (const Vertex& v : mesh.cpuVertices()) {
+            Vertex w;
+            w.position = vec3(world * vec4(v.position, 1.0));
+            w.normal = glm::vec3(glm::normalize(normalMatrix * vec3(v.normal)));
+            w.texCoord = v.texCoord;
+            vertices.push_back(w);
+        }
+        const size_t indexCount = mesh.getIndexCount();
+        if (indexCount > 0) {
+            const unsigned int* meshIndices = mesh.indexData();
+            for (size_t i = 0; i < indexCount; ++i) indices.push_back(base + meshIndices[i]);
+        }
+        else {
+            for (uint32_t i = 0; i < (uint32_t)mesh.getVertexCount(); ++i) indices.push_back(base + i);
+        }
+    }
+
+    const GpuGeometry geo = Mesh::uploadGeometry(vertices, indices);
+    batch.VAO = geo.VAO;
+    batch.VBO = geo.VBO;
+    batch.EBO = geo.EBO;
+    batch.vertexCount = vertices.size();
+    batch.indexCount = indices.size();
+    batch.objectCount = batch.members.size();
+    batch.gpuBytes = geo.bytes;
+}
+
+size_t StaticBatcher::gpuBytes() const {
+    size_t total = 0;
+    for (const Batch& b : batches_) total += b.gpuBytes;
+    return total;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "GameObject.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <GL/glew.h>
+
+// Lotes de geometria estatica: los GameObject marcados isStatic que comparten
+// textura se fusionan en un unico VBO/EBO con la transformacion de mundo ya
+// aplicada a los vertices. Cada objeto conserva su rango de indices, asi el
+// culling sigue siendo por objeto y el renderer dibuja solo los rangos visibles
+// de cada lote en una llamada (glMultiDrawElements).
+class StaticBatcher {
+public:
+    static constexpr uint32_t kNoBatch = 0xFFFFFFFFu;
+
+    struct Range {
+        uint32_t batch = 0;
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+    };
+
+    struct Batch {
+        GLuint VAO = 0;
+        GLuint VBO = 0;
+        GLuint EBO = 0;
+        GLuint texture = 0;
+        size_t vertexCount = 0;
+        size_t indexCount = 0;
+        size_t objectCount = 0;
+        size_t gpuBytes = 0;
+        std::vector<GameObject*> members; // En el orden de sus rangos
+    };
+
+    // Rehace los lotes si algun objeto estatico ha cambiado. Altas, bajas, mesh o
+    // textura reconstruyen todo; una matriz de mundo distinta solo rehace el lote
+    // del objeto. Llamar despues de actualizar las transformaciones.
+    void sync(const std::vector<std::shared_ptr<GameObject>>& scene);
+    void clear();
+
+    const std::vector<Batch>& batches() const { return batches_; }
+    // Rango de un objeto a partir de GameObject::staticBatchHandle
+    const Range& range(uint32_t handle) const { return ranges_[handle]; }
+    size_t objectCount() const { return objects_.size(); }
+    // Draw calls que costaban estos objetos sin lotes (uno por objeto)
+    size_t mergedDraws() const { return objects_.size(); }
+    size_t gpuBytes() const;
+
+private:
+    // Por encima, un lote nuevo: evita subir de golpe buffers enormes
+    static constexpr size_t kMaxBatchVertices = 1u << 20;
+
+    // Lo que se comprobo al construir; si cambia, hay que reconstruir
+    struct Entry {
+        GameObject* object = nullptr;
+        const Mesh* mesh = nullptr;
+        GLuint texture = 0;
+        uint64_t worldStamp = 0;
+        mat4 world = mat4(1.0);   // Un stamp nuevo con la misma matriz no cuesta nada
+        uint32_t batch = kNoBatch;
+    };
+
+    static bool isBatchable(const GameObject& go);
+    bool structureChanged(const std::vector<std::shared_ptr<GameObject>>& scene) const;
+    void rebuild(const std::vector<std::shared_ptr<GameObject>>& scene);
+    void uploadBatch(Batch& batch);
+    static void releaseBatch(Batch& batch);
+    void releaseBatches();
+
+    std::vector<Entry> objects_;
+    std::vector<std::shared_ptr<GameObject>> owners_; // Para limpiar los handles aunque la escena los suelte
+    std::vector<Range> ranges_;                       // Indexado por staticBatchHandle
+    std::vector<Batch> batches_;
+};
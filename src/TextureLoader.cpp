@@ -4,10 +4,13 @@
 #include <IL/il.h>
 #include <IL/ilu.h>
 #include <SDL3/SDL_opengl.h>  
+#include <mutex>
 
 static bool g_devILInited = false;
+// DevIL tiene una imagen enlazada global: una decodificacion a la vez
+static std::mutex g_devILMutex;
 
-void EnsureDevILInited() {
+static void InitDevILLocked() {
     if (!g_devILInited) {
         ilInit();
         iluInit();
@@ -15,52 +18,84 @@ void EnsureDevILInited() {
     }
 }
 
-unsigned int LoadTexture2D(const std::string& path) {
-    EnsureDevILInited();
+void EnsureDevILInited() {
+    std::lock_guard<std::mutex> lock(g_devILMutex);
+    InitDevILLocked();
+}
+
+bool DecodeTexture2D(const std::string& path, DecodedTexture& out) {
     AssetMeta meta;
     std::string metaPath = path + ".meta";
     bool hasMeta = AssetMeta::loadFromFile(metaPath, meta);
-    ILuint img = 0;
-    ilGenImages(1, &img);
-    ilBindImage(img);
-    if (!ilLoadImage(path.c_str())) {
+    {
+        std::lock_guard<std::mutex> lock(g_devILMutex);
+        InitDevILLocked();
+        ILuint img = 0;
+        ilGenImages(1, &img);
+        ilBindImage(img);
+        if (!ilLoadImage(path.c_str())) {
+            ilDeleteImages(1, &img);
+            return false;
+        }
+        if (hasMeta) {
+            if (meta.texFlipY) iluFlipImage();
+            if (meta.texFlipX) iluMirror();
+        }
+        ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE);
+        const int w = ilGetInteger(IL_IMAGE_WIDTH);
+        const int h = ilGetInteger(IL_IMAGE_HEIGHT);
+        const ILubyte* pixels = ilGetData();
+        if (!pixels || w <= 0 || h <= 0) {
+            ilDeleteImages(1, &img);
+            return false;
+        }
+        out.pixels.assign(pixels, pixels + size_t(w) * size_t(h) * 4);
+        out.width = w;
+        out.height = h;
+        ilBindImage(0);
         ilDeleteImages(1, &img);
-        return 0;
     }
+    out.path = path;
+    out.minFilter = GL_LINEAR;
+    out.magFilter = GL_LINEAR;
+    out.wrapS = GL_REPEAT;
+    out.wrapT = GL_REPEAT;
+    out.mipmaps = false;
     if (hasMeta) {
-        if (meta.texFlipY) iluFlipImage();
-        if (meta.texFlipX) iluMirror();
-    }
-    ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE);
-    const int w = ilGetInteger(IL_IMAGE_WIDTH);
-    const int h = ilGetInteger(IL_IMAGE_HEIGHT);
-    const void* pixels = ilGetData();
-    if (!pixels || w <= 0 || h <= 0) {
-        ilDeleteImages(1, &img);
-        return 0;
+        if (meta.texMinFilter == "Nearest") out.minFilter = GL_NEAREST;
+        else if (meta.texMinFilter == "Trilinear") out.minFilter = GL_LINEAR_MIPMAP_LINEAR;
+        if (meta.texMagFilter == "Nearest") out.magFilter = GL_NEAREST;
+        if (meta.texWrapS == "ClampToEdge") out.wrapS = GL_CLAMP_TO_EDGE;
+        else if (meta.texWrapS == "MirroredRepeat") out.wrapS = GL_MIRRORED_REPEAT;
+        if (meta.texWrapT == "ClampToEdge") out.wrapT = GL_CLAMP_TO_EDGE;
+        else if (meta.texWrapT == "MirroredRepeat") out.wrapT = GL_MIRRORED_REPEAT;
+        out.mipmaps = meta.texMipmaps || meta.texMinFilter == "Trilinear";
     }
+    return true;
+}
+
+unsigned int UploadTexture2D(const DecodedTexture& texture) {
+    if (texture.pixels.empty()) return 0;
     GLuint tex = 0;
     glGenTextures(1, &tex);
     glBindTexture(GL_TEXTURE_2D, tex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
-    GLint minf = GL_LINEAR, magf = GL_LINEAR, wrapS = GL_REPEAT, wrapT = GL_REPEAT;
-    if (hasMeta) {
-        if (meta.texMinFilter == "Nearest") minf = GL_NEAREST;
-        else if (meta.texMinFilter == "Trilinear") minf = GL_LINEAR_MIPMAP_LINEAR;
-        if (meta.texMagFilter == "Nearest") magf = GL_NEAREST;
-        if (meta.texWrapS == "ClampToEdge") wrapS = GL_CLAMP_TO_EDGE;
-        else if (meta.texWrapS == "MirroredRepeat") wrapS = GL_MIRRORED_REPEAT;
-        if (meta.texWrapT == "ClampToEdge") wrapT = GL_CLAMP_TO_EDGE;
-        else if (meta.texWrapT == "MirroredRepeat") wrapT = GL_MIRRORED_REPEAT;
-    }
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minf);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magf);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapS);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapT);
-    if (hasMeta && (meta.texMipmaps || meta.texMinFilter == "Trilinear")) {
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, texture.width, texture.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, texture.pixels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (GLint)texture.minFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, (GLint)texture.magFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, (GLint)texture.wrapS);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, (GLint)texture.wrapT);
+    if (texture.mipmaps) {
         glGenerateMipmap(GL_TEXTURE_2D);
     }
-    ilBindImage(0);
-    ilDeleteImages(1, &img);
     return tex;
 }
+
+unsigned int LoadTexture2D(const std::string& path) {
+    DecodedTexture texture;
+    if (!DecodeTexture2D(path, texture)) return 0;
+    return UploadTexture2D(texture);
+}
+
+TextureResource::~TextureResource() {
+    if (id) glDeleteTextures(1, &id);
+}
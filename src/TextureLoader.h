@@ -1,6 +1,35 @@
 #pragma once
 #include <string>
+#include <vector>
 #include <cstdint>
+#include <cstddef>
 
+// Imagen ya decodificada (RGBA8) con los parametros de GL de su .meta.
+// DecodeTexture2D no toca GL y se puede llamar desde cualquier hilo;
+// UploadTexture2D solo desde el principal
+struct DecodedTexture {
+    std::string path;
+    std::vector<uint8_t> pixels;
+    int width = 0;
+    int height = 0;
+    unsigned int minFilter = 0;
+    unsigned int magFilter = 0;
+    unsigned int wrapS = 0;
+    unsigned int wrapT = 0;
+    bool mipmaps = false;
+
+    // Lo que cuesta subirla, con la cadena de mipmaps si la lleva
+    size_t uploadBytes() const { return pixels.size() + (mipmaps ? pixels.size() / 3 : 0); }
+};
+
+bool DecodeTexture2D(const std::string& path, DecodedTexture& out);
+unsigned int UploadTexture2D(const DecodedTexture& texture);
+// Decode + upload, sincrono
 unsigned int LoadTexture2D(const std::string& path);
-void EnsureDevILInited();
\ No newline at end of file
+void EnsureDevILInited();
+
+// Textura GL compartida (ResourceManager); se borra con la ultima referencia
+struct TextureResource {
+    unsigned int id = 0;
+    ~TextureResource();
+};
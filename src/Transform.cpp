@@ -1,10 +1,22 @@
 #include "Transform.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <cmath>
+#include <atomic>
 
-void Transform::translate(const vec3& v) { _mat = glm::translate(_mat, v); }
-void Transform::rotate(double rads, const vec3& v) { _mat = glm::rotate(_mat, rads, v); }
+static std::atomic<uint64_t> s_versionCounter{ 0 };
+
+uint64_t Transform::nextVersion() {
+    return ++s_versionCounter;
+}
+
+uint64_t Transform::reserveVersions(uint64_t n) {
+    return s_versionCounter.fetch_add(n) + 1;
+}
+
+void Transform::translate(const vec3& v) { _mat = glm::translate(_mat, v); _version = nextVersion(); }
+void Transform::rotate(double rads, const vec3& v) { _mat = glm::rotate(_mat, rads, v); _version = nextVersion(); }
 void Transform::setPosition(const vec3& t) {
+    _version = nextVersion();
     _pos = t;
     _pos_w = (mat4::value_type)1;
 }
@@ -31,6 +43,7 @@ void Transform::setScale(const vec3& s) {
     vec3 nx = norm_safe(_left, 0);
     vec3 ny = norm_safe(_up, 1);
     vec3 nz = norm_safe(_fwd, 2);
+    _version = nextVersion();
     _left = nx * s.x;  _left_w = (mat4::value_type)0;
     _up = ny * s.y;  _up_w = (mat4::value_type)0;
     _fwd = nz * s.z;  _fwd_w = (mat4::value_type)0;
@@ -51,6 +64,7 @@ void Transform::rotateEulerDeltaDeg(const vec3& degXYZ) {
 void Transform::resetRotation() {
     vec3 T = _pos;
     vec3 S = getScale();
+    _version = nextVersion();
     _left = vec3(S.x, 0, 0);  _left_w = (mat4::value_type)0;
     _up = vec3(0, S.y, 0);  _up_w = (mat4::value_type)0;
     _fwd = vec3(0, 0, S.z);  _fwd_w = (mat4::value_type)0;
@@ -1,5 +1,6 @@
 #pragma once
 #include "types.h"
+#include <cstdint>
 
 class Transform {
 	union {
@@ -11,16 +12,27 @@ class Transform {
 			vec3 _pos; mat4::value_type _pos_w;
 		};
 	};
+	// Cambia en cada mutacion, desde un contador global. Una copia se lleva la
+	// version con la matriz, asi que la garantia es: misma version, misma matriz
+	// (y las caches pueden compararla sin mas).
+	uint64_t _version = nextVersion();
 
 public:
+	static uint64_t nextVersion();
+	// Reserva n versiones consecutivas y devuelve la primera
+	static uint64_t reserveVersions(uint64_t n);
+	uint64_t version() const { return _version; }
+
 	const auto& mat() const { return _mat; }
-	auto& mat_mutable() { return _mat; }
+	// Quien pide acceso de escritura se considera que modifica la matriz
+	auto& mat_mutable() { _version = nextVersion(); return _mat; }
 	const auto& left() const { return _left; }
 	vec3 right() const { return -_left; }
 	const auto& up() const { return _up; }
 	const auto& fwd() const { return _fwd; }
+	// Solo lectura: un getter no-const subiria la version en cada lectura (el
+	// Inspector lee cada frame). Para escribir, setPosition/translate
 	const auto& pos() const { return _pos; }
-	auto& pos() { return _pos; }
 	void translate(const vec3& v);
 	void rotate(double rads, const vec3& v);
 	void setPosition(const vec3& t);
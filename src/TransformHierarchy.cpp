@@ -0,0 +1,124 @@
+#include "TransformHierarchy.h"
+#include "JobSystem.h"
+#include <unordered_map>
+#include <chrono>
+#include <atomic>
+
+bool TransformHierarchy::structureChanged(const std::vector<std::shared_ptr<GameObject>>& scene) const {
+    if (scene.size() != objects.size() || scene.size() != sceneObjects.size()) return true;
+    for (size_t i = 0; i < scene.size(); ++i) {
+        if (scene[i].get() != sceneObjects[i]) return true;
+    }
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (objects[i]->parent != parentPtrs[i]) return true;
+        if (objects[i]->children.size() != childCounts[i]) return true;
+    }
+    return false;
+}
+
+void TransformHierarchy::sync(const std::vector<std::shared_ptr<GameObject>>& scene) {
+    if (structureChanged(scene)) rebuild(scene);
+}
+
+void TransformHierarchy::clear() {
+    objects.clear();
+    owners.clear();
+    parents.clear();
+    parentPtrs.clear();
+    childCounts.clear();
+    sceneObjects.clear();
+    levels.clear();
+}
+
+void TransformHierarchy::rebuild(const std::vector<std::shared_ptr<GameObject>>& scene) {
+    clear();
+
+    std::unordered_map<const GameObject*, const std::shared_ptr<GameObject>*> inScene;
+    inScene.reserve(scene.size());
+    sceneObjects.reserve(scene.size());
+    for (const auto& go : scene) {
+        inScene[go.get()] = &go;
+        sceneObjects.push_back(go.get());
+    }
+
+    std::unordered_map<const GameObject*, uint32_t> indexOf;
+    indexOf.reserve(scene.size());
+    auto append = [&](const std::shared_ptr<GameObject>& go, uint32_t parent) {
+        indexOf[go.get()] = (uint32_t)objects.size();
+        objects.push_back(go.get());
+        owners.push_back(go);
+        parents.push_back(parent);
+        parentPtrs.push_back(go->parent);
+        childCounts.push_back((uint32_t)go->children.size());
+    };
+
+    // Nivel 0: raices, y objetos cuyo padre no esta en la escena
+    levels.push_back(0);
+    for (const auto& go : scene) {
+        if (!go->parent || !inScene.count(go->parent)) append(go, kNoParent);
+    }
+
+    // Siguientes niveles: hijos de los del nivel anterior
+    while (levels.back() < objects.size()) {
+        const size_t begin = levels.back();
+        const size_t end = objects.size();
+        levels.push_back((uint32_t)end);
+        for (size_t i = begin; i < end; ++i) {
+            for (GameObject* child : objects[i]->children) {
+                auto it = inScene.find(child);
+                if (it == inScene.end() || indexOf.count(child)) continue;
+                append(*it->second, (uint32_t)i);
+            }
+        }
+    }
+
+    local.resize(objects.size());
+    world.resize(objects.size());
+    localVersions.assign(objects.size(), 0);
+    changed.assign(objects.size(), 0);
+}
+
+void TransformHierarchy::update() {
+    auto start = std::chrono::high_resolution_clock::now();
+    if (objects.empty()) { updateMs = 0.0; updatedCount = 0; return; }
+
+    // Versiones para todo el frame de una vez: sin contencion en el contador global
+    const uint64_t stampBase = Transform::reserveVersions(objects.size());
+
+    // Raices cuyo padre vive fuera de la escena: validar antes su cache en este
+    // hilo, para que en paralelo solo se lea
+    for (size_t i = levels[0]; i < levels[1]; ++i) {
+        if (parentPtrs[i]) parentPtrs[i]->worldMatrix();
+    }
+
+    std::atomic<size_t> updated{ 0 };
+    for (size_t l = 0; l + 1 < levels.size(); ++l) {
+        const size_t levelBegin = levels[l];
+        const size_t levelEnd = levels[l + 1];
+        // Cada nivel solo lee mundos del anterior, ya terminado: sus elementos son independientes
+        JobSystem::instance().parallelFor(levelEnd - levelBegin, kMinBatch, [&](size_t b, size_t e) {
+            size_t count = 0;
+            for (size_t i = levelBegin + b; i < levelBegin + e; ++i) {
+                GameObject* go = objects[i];
+                const uint64_t version = go->transform.version();
+                const bool dirty = version != localVersions[i] ||
+                    (parents[i] != kNoParent ? changed[parents[i]] != 0 : parentPtrs[i] != nullptr);
+                changed[i] = dirty;
+                if (!dirty) continue; // Su cache sigue valida: mismo local y mismo padre
+
+                local[i] = go->transform.mat();
+                if (parents[i] != kNoParent) world[i] = world[parents[i]] * local[i];
+                else if (parentPtrs[i]) world[i] = parentPtrs[i]->worldMatrix() * local[i];
+                else world[i] = local[i];
+                go->setCachedWorld(world[i], stampBase + i);
+                localVersions[i] = version;
+                ++count;
+            }
+            updated += count;
+        });
+    }
+
+    updatedCount = updated;
+    auto end = std::chrono::high_resolution_clock::now();
+    updateMs = std::chrono::duration<double, std::milli>(end - start).count();
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "GameObject.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// Copia de la jerarquia de la escena en arrays contiguos, en orden de anchura
+// (todos los padres antes que sus hijos). Las matrices de mundo se recalculan
+// en una pasada lineal por nivel, repartiendo cada nivel entre los workers, y
+// se vuelcan a la cache de cada GameObject (GameObject::worldMatrix).
+// Solo se recalculan los objetos cuyo Transform cambio o cuyo padre se recalculo.
+class TransformHierarchy {
+public:
+    // Reordena si la estructura de la escena ha cambiado (altas, bajas, reparent)
+    void sync(const std::vector<std::shared_ptr<GameObject>>& scene);
+    void update();
+    void clear();
+
+    size_t size() const { return objects.size(); }
+    size_t levelCount() const { return levels.empty() ? 0 : levels.size() - 1; }
+    double lastUpdateMs() const { return updateMs; }
+    size_t lastUpdatedCount() const { return updatedCount; }
+
+private:
+    static constexpr uint32_t kNoParent = 0xFFFFFFFFu;
+    static constexpr size_t kMinBatch = 1024; // Por debajo no compensa repartir
+
+    bool structureChanged(const std::vector<std::shared_ptr<GameObject>>& scene) const;
+    void rebuild(const std::vector<std::shared_ptr<GameObject>>& scene);
+
+    std::vector<GameObject*> objects;
+    std::vector<std::shared_ptr<GameObject>> owners; // Mantiene vivos los objetos hasta el proximo sync
+    std::vector<uint32_t> parents;       // Indice del padre en estos arrays, o kNoParent
+    std::vector<GameObject*> parentPtrs; // Puntero del padre al construir, para detectar reparent
+    std::vector<uint32_t> childCounts;
+    // La escena al construir, en su orden (objects va por niveles): un borrado y
+    // un alta en el mismo frame dejan el tamano igual pero cambian la identidad
+    std::vector<const GameObject*> sceneObjects;
+    std::vector<uint32_t> levels;        // Inicio de cada nivel, mas el final
+    std::vector<mat4> local;
+    std::vector<mat4> world;
+    std::vector<uint64_t> localVersions; // Version del Transform usada en el ultimo calculo; 0 = nunca
+    std::vector<uint8_t> changed;        // Recalculado este frame: sus hijos tambien lo estan
+    double updateMs = 0.0;
+    size_t updatedCount = 0;
+};
@@ -11,6 +11,7 @@
 #include <chrono>
 #include <vector>
 #include <memory>
+#include <functional>
 #include <string>
 #include <algorithm>
 #include "EditorWindows.h"
@@ -21,8 +22,17 @@
 #include "AABB.h"
 #include "Frustum.h"
 #include "Octree.h"
+#include "TransformHierarchy.h"
+#include "StaticBatcher.h"
+#include "FrustumBatch.h"
 #include "SceneSerializer.h"
 #include "Framebuffer.h" // [NEW]
+#include "Renderer.h"
+#include "DebugDraw.h"
+#include "GpuPicker.h"
+#include "OutlinePass.h"
+#include "AsyncModelLoader.h"
+#include "ResourceManager.h"
 
 using namespace std;
 namespace fs = std::filesystem;
@@ -33,6 +43,8 @@ static bool editorCameraInitialized = false;
 
 // [NEW] Octree instance
 static Octree mainOctree(AABB(vec3(-200, -200, -200), vec3(200, 200, 200)));
+static TransformHierarchy sceneTransforms; // Matrices de mundo de toda la escena, una pasada por frame
+static StaticBatcher staticBatches;        // Geometria de los objetos isStatic fusionada por textura
 // [NEW] Viewport Framebuffers
 static Framebuffer sceneFramebuffer;
 static Framebuffer gameFramebuffer;
@@ -46,6 +58,8 @@ static SDL_GLContext glContext = nullptr;
 static bool running = true;
 static vector<shared_ptr<GameObject>> gameObjects;
 static shared_ptr<GameObject> selectedGameObject = nullptr;
+// Reused every frame by octree queries so culling doesn't allocate
+static vector<GameObject*> visibleObjects;
 
 // [NEW] Simulation State
 static bool isPlaying = false;
@@ -85,37 +99,67 @@ static std::string getLibraryPathPortable(const std::string& assetsPath) {
     return fs::absolute(p).string();
 }
 
-static void loadModelToScene(const std::string& filename, const std::string& namePrefix) {
+// Carga el modelo en segundo plano (una sola vez aunque se pida muchas: los meshes
+// los comparte el ResourceManager). El GameObject del primer sub-mesh se crea ya,
+// sin mesh (placeholder), y los demas aparecen cuando termina la subida. setup
+// configura cada objeto segun su indice de sub-mesh.
+static std::shared_ptr<ModelHandle> spawnModelAsync(const std::string& path, const std::string& namePrefix,
+    const std::function<void(GameObject&, int)>& setup) {
+    auto placeholder = std::make_shared<GameObject>(namePrefix + "_0");
+    setup(*placeholder, 0);
+    placeholder->meshLoading = true;
+    gameObjects.push_back(placeholder);
+
+    std::weak_ptr<GameObject> weak = placeholder;
+    auto handle = ResourceManager::instance().loadModel(path);
+    handle->then([weak, path, namePrefix, setup](const ModelHandle& h) {
+        auto first = weak.lock();
+        auto it = std::find(gameObjects.begin(), gameObjects.end(), first);
+        // Borrado, o escena recargada, mientras cargaba
+        if (!first || it == gameObjects.end()) return;
+        first->meshLoading = false;
+
+        const auto& meshes = h.meshes();
+        if (meshes.empty()) {
+            std::cerr << "[ERROR] Failed to load " << path << std::endl;
+            if (first->children.empty()) {
+                if (first->parent) first->parent->removeChild(first.get());
+                if (selectedGameObject == first) selectedGameObject = nullptr;
+                gameObjects.erase(it);
+            }
+            return;
+        }
+        std::cout << "[Scene] Loaded " << path << " with " << meshes.size() << " meshes." << std::endl;
+
+        ResourceManager& resources = ResourceManager::instance();
+        first->setMesh(resources.acquireMesh(h, 0));
+        mainOctree.insert(first);
+        for (size_t i = 1; i < meshes.size(); i++) {
+            auto gameObject = std::make_shared<GameObject>(namePrefix + "_" + std::to_string(i));
+            setup(*gameObject, (int)i);
+            gameObject->setMesh(resources.acquireMesh(h, i));
+            gameObjects.push_back(gameObject);
+            mainOctree.insert(gameObject);
+        }
+    });
+    return handle;
+}
+
+static std::shared_ptr<ModelHandle> loadModelToScene(const std::string& filename, const std::string& namePrefix, bool isStatic = false) {
     std::string assetsPath = getAssetsPath();
     fs::path modelPath = fs::absolute(fs::path(assetsPath) / filename);
     
     if (!fs::exists(modelPath)) {
         std::cerr << "[ERROR] " << filename << " not found at: " << modelPath.string() << std::endl;
-        return;
+        return nullptr;
     }
 
-    auto meshes = ModelLoader::loadModel(modelPath.string());
-    if (meshes.empty()) {
-        std::cerr << "[ERROR] Failed to load " << filename << std::endl;
-        return;
-    }
-
-    std::cout << "[Scene] Loaded " << filename << " with " << meshes.size() << " meshes." << std::endl;
-
-    for (size_t i = 0; i < meshes.size(); i++) {
-        auto gameObject = std::make_shared<GameObject>(namePrefix + "_" + std::to_string(i));
-        gameObject->setMesh(meshes[i]);
-        
+    return spawnModelAsync(modelPath.string(), namePrefix, [filename, isStatic](GameObject& go, int meshIndex) {
         // [NEW] Store metadata for serialization
-        gameObject->modelPath = filename;
-        gameObject->meshIndex = (int)i;
-        
-        // Optional: Position BakerHouse slightly differently so it's not inside the street or vice versa?
-        // For now, load at origin as requested.
-        
-        gameObjects.push_back(gameObject);
-        mainOctree.insert(gameObject);
-    }
+        go.modelPath = filename;
+        go.meshIndex = meshIndex;
+        go.isStatic = isStatic;
+    });
 }
 
 
@@ -147,9 +191,7 @@ static void focusEditorCameraOnScene() {
 
     for (const auto& go : gameObjects) {
         if (go->mesh) {
-            mat4 worldMatrix = computeWorldMatrix(go.get());
-            AABB worldAABB = go->mesh->getWorldAABB(worldMatrix);
-            sceneBounds.merge(worldAABB);
+            sceneBounds.merge(go->worldAABB());
             anyMesh = true;
         }
     }
@@ -166,45 +208,46 @@ static void loadDefaultScene() {
     gameObjects.clear(); // Clear existing objects if any
     
     std::cout << "Loading Default Scene..." << std::endl;
-    loadModelToScene("street.fbx", "Street");
-    loadModelToScene("BakerHouse.fbx", "BakerHouse");
+    // Escenario fijo: va a los lotes estaticos
+    auto street = loadModelToScene("street.fbx", "Street", true);
+    auto house = loadModelToScene("BakerHouse.fbx", "BakerHouse", true);
     
     createMainCamera();
     focusEditorCameraOnScene();
+
+    // Los meshes llegan unos frames despues: se encuadra otra vez con los dos cargados
+    auto remaining = std::make_shared<int>(0);
+    for (const auto& handle : { street, house }) {
+        if (!handle) continue;
+        ++*remaining;
+        handle->then([remaining](const ModelHandle&) {
+            if (--*remaining == 0) focusEditorCameraOnScene();
+        });
+    }
 }
 
 static void loadModelFromFile(const string& filepath) {
     cout << "Loading model from: " << filepath << endl;
-    auto meshes = ModelLoader::loadModel(filepath);
-    if (meshes.empty()) {
-        cerr << "ERROR: Failed to load model from: " << filepath << endl;
-        return;
-    }
-    cout << "Model loaded successfully with " << meshes.size() << " meshes." << endl;
     size_t lastSlash = filepath.find_last_of("/\\");
     size_t lastDot = filepath.find_last_of(".");
     string modelName = filepath.substr(lastSlash + 1, lastDot - lastSlash - 1);
-    for (size_t i = 0; i < meshes.size(); i++) {
-        auto gameObject = make_shared<GameObject>(modelName + "_" + to_string(i));
-        gameObject->setMesh(meshes[i]);
-        gameObject->transform.pos() = vec3(gameObjects.size() * 2.0, 0, 0);
-        gameObjects.push_back(gameObject);
-        mainOctree.insert(gameObject); // [NEW] Insert into Octree
-    }
+    spawnModelAsync(filepath, modelName, [](GameObject& go, int) {
+        go.transform.setPosition(vec3(gameObjects.size() * 2.0, 0, 0));
+    });
 }
 
 static void loadTextureFromFile(const string& filepath) {
     cout << "Loading texture from: " << filepath << endl;
-    GLuint textureID = ModelLoader::loadTexture(filepath);
-    if (textureID == 0) {
+    auto texture = ResourceManager::instance().acquireTexture(filepath);
+    if (!texture) {
         cerr << "ERROR: Failed to load texture from: " << filepath << endl;
         return;
     }
-    cout << "Texture loaded successfully (ID: " << textureID << ")" << endl;
+    cout << "Texture loaded successfully (ID: " << texture->id << ")" << endl;
     int appliedCount = 0;
     for (auto& go : gameObjects) {
         if (go->isSelected) {
-            go->setTexture(textureID);
+            go->setTexture(texture);
             appliedCount++;
         }
     }
@@ -266,97 +309,15 @@ static void draw_triangle(const glm::u8vec3& color, const vec3& center, double s
     glEnd();
 }
 
-static void draw_floorGrid(int size, double step) {
-    glColor3ub(100, 100, 100);
-    glBegin(GL_LINES);
-    for (double i = -size; i <= size; i += step) {
-        glVertex3d(i, 0, -size);
-        glVertex3d(i, 0, size);
-        glVertex3d(-size, 0, i);
-        glVertex3d(size, 0, i);
-    }
-    glEnd();
-}
-
 static void drawAABB(const AABB& box, const glm::u8vec3& color) {
-    glDisable(GL_LIGHTING);
-    glColor3ub(color.r, color.g, color.b);
-    glLineWidth(2.0f);
-    vec3 min = box.min;
-    vec3 max = box.max;
-    glBegin(GL_LINES);
-    glVertex3d(min.x, min.y, min.z); glVertex3d(max.x, min.y, min.z);
-    glVertex3d(max.x, min.y, min.z); glVertex3d(max.x, min.y, max.z);
-    glVertex3d(max.x, min.y, max.z); glVertex3d(min.x, min.y, max.z);
-    glVertex3d(min.x, min.y, max.z); glVertex3d(min.x, min.y, min.z);
-    glVertex3d(min.x, max.y, min.z); glVertex3d(max.x, max.y, min.z);
-    glVertex3d(max.x, max.y, min.z); glVertex3d(max.x, max.y, max.z);
-    glVertex3d(max.x, max.y, max.z); glVertex3d(min.x, max.y, max.z);
-    glVertex3d(min.x, max.y, max.z); glVertex3d(min.x, max.y, min.z);
-    glVertex3d(min.x, min.y, min.z); glVertex3d(min.x, max.y, min.z);
-    glVertex3d(max.x, min.y, min.z); glVertex3d(max.x, max.y, min.z);
-    glVertex3d(max.x, min.y, max.z); glVertex3d(max.x, max.y, max.z);
-    glVertex3d(min.x, min.y, max.z); glVertex3d(min.x, max.y, max.z);
-    glEnd();
-    glLineWidth(1.0f);
-    glEnable(GL_LIGHTING);
+    DebugDraw::instance().box(box, color, 2.0f);
 }
 
 static void drawFrustum(const Frustum& frustum, const mat4& invProjView, const glm::u8vec3& color) {
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
-    glColor3ub(color.r, color.g, color.b);
-    glLineWidth(2.0f);
-
-    // Obtener las 8 esquinas del frustum
+    // Obtener las 8 esquinas del frustum; se dibuja encima de todo
     vec3 corners[8];
     frustum.getCorners(corners, invProjView);
-
-    glBegin(GL_LINES);
-
-    // Near plane
-    glVertex3d(corners[0].x, corners[0].y, corners[0].z);
-    glVertex3d(corners[1].x, corners[1].y, corners[1].z);
-
-    glVertex3d(corners[1].x, corners[1].y, corners[1].z);
-    glVertex3d(corners[3].x, corners[3].y, corners[3].z);
-
-    glVertex3d(corners[3].x, corners[3].y, corners[3].z);
-    glVertex3d(corners[2].x, corners[2].y, corners[2].z);
-
-    glVertex3d(corners[2].x, corners[2].y, corners[2].z);
-    glVertex3d(corners[0].x, corners[0].y, corners[0].z);
-
-    // Far plane (4 líneas)
-    glVertex3d(corners[4].x, corners[4].y, corners[4].z);
-    glVertex3d(corners[5].x, corners[5].y, corners[5].z);
-
-    glVertex3d(corners[5].x, corners[5].y, corners[5].z);
-    glVertex3d(corners[7].x, corners[7].y, corners[7].z);
-
-    glVertex3d(corners[7].x, corners[7].y, corners[7].z);
-    glVertex3d(corners[6].x, corners[6].y, corners[6].z);
-
-    glVertex3d(corners[6].x, corners[6].y, corners[6].z);
-    glVertex3d(corners[4].x, corners[4].y, corners[4].z);
-
-    // Connecting lines
-    glVertex3d(corners[0].x, corners[0].y, corners[0].z);
-    glVertex3d(corners[4].x, corners[4].y, corners[4].z);
-
-    glVertex3d(corners[1].x, corners[1].y, corners[1].z);
-    glVertex3d(corners[5].x, corners[5].y, corners[5].z);
-
-    glVertex3d(corners[2].x, corners[2].y, corners[2].z);
-    glVertex3d(corners[6].x, corners[6].y, corners[6].z);
-
-    glVertex3d(corners[3].x, corners[3].y, corners[3].z);
-    glVertex3d(corners[7].x, corners[7].y, corners[7].z);
-
-    glEnd();
-    glLineWidth(1.0f);
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
+    DebugDraw::instance().frustum(corners, color, 2.0f, false);
 }
 
 static void updateProjection(int width, int height) {
@@ -402,6 +363,51 @@ static Ray getRayFromMouse(int mouseX, int mouseY, const vec3& camPos, const mat
     return Ray(camPos, direction);
 }
 
+// Culling sin octree: todas las AABB de la escena en un lote y test SIMD
+static void cullWithoutOctree(const Frustum& frustum, vector<GameObject*>& out) {
+    static AABBBatch boxes;
+    static vector<GameObject*> candidates;
+    static vector<uint8_t> visible;
+    boxes.clear();
+    candidates.clear();
+    out.clear();
+    for (auto& go : gameObjects) {
+        if (!go->mesh) continue;
+        candidates.push_back(go.get());
+        boxes.push(go->worldAABB());
+    }
+    FrustumBatch::cull(frustum, boxes, visible);
+    for (size_t i = 0; i < candidates.size(); ++i)
+        if (visible[i]) out.push_back(candidates[i]);
+}
+
+static void collectVisible(const Frustum& frustum, vector<GameObject*>& out) {
+    if (editor.isOctreeEnabled()) mainOctree.queryFrustum(frustum, out);
+    else cullWithoutOctree(frustum, out);
+}
+
+// Culling + dibujado de los objetos con el backend elegido al arrancar
+static void drawScene(const Frustum& frustum, const mat4& view, const mat4& proj) {
+    if (editor.isFrustumCullingEnabled()) {
+        collectVisible(frustum, visibleObjects);
+    } else {
+        visibleObjects.clear();
+        for (const auto& go : gameObjects) if (go->mesh) visibleObjects.push_back(go.get());
+    }
+
+    // La cola ordena por estado y profundidad; sirve para los dos backends
+    Renderer& renderer = Renderer::instance();
+    renderer.beginPass(view, proj);
+    for (GameObject* go : visibleObjects) renderer.submit(*go);
+    renderer.endPass();
+}
+
+static shared_ptr<GameObject> findSceneObject(const GameObject* raw) {
+    if (!raw) return nullptr;
+    for (auto& go : gameObjects) if (go.get() == raw) return go;
+    return nullptr;
+}
+
 static shared_ptr<GameObject> selectWithRaycast(int mouseX, int mouseY) {
     if (gameObjects.empty()) return nullptr;
     int screenWidth, screenHeight;
@@ -418,38 +424,17 @@ static shared_ptr<GameObject> selectWithRaycast(int mouseX, int mouseY) {
         ray = getRayFromMouse(mouseX, mouseY, mainCamera->transform.pos(), proj, view, screenWidth, screenHeight);
     }
     
-    // [NEW] Use Octree to get candidates
-    // Note: If Objects moved, we should ideally update octree.
-    // For now, assuming static scene or that user will accept some inaccuracies if moving things wildly.
-    auto candidates = mainOctree.queryRay(ray);
-    
-    // If octree is empty or something fails, fallback to all? 
-    // No, empty candidates means no intersection with large boxes.
-    // However, since we might dynamically add objects without inserting (if I missed a spot), 
-    // let's stick to candidates.
-    
-    // Fallback: If candidates empty but gameObjects not empty, maybe Octree not populated?
-    // Should be populated.
-    
-    shared_ptr<GameObject> closest = nullptr;
-    double closestDist = std::numeric_limits<double>::max();
-
-    for (auto& go : candidates) {
-        if (!go->mesh) continue;
-        mat4 worldMatrix = computeWorldMatrix(go.get());
-        AABB worldAABB = go->mesh->getWorldAABB(worldMatrix);
-        double t;
-        if (ray.intersectsAABB(worldAABB, t)) {
-            if (t < closestDist) {
-                closestDist = t;
-                closest = go;
-            }
-        }
-    }
-    return closest;
+    // Los objetos movidos se recolocan con Octree::update: el arbol siempre esta al dia
+    return findSceneObject(mainOctree.raycastClosest(ray));
 }
 
 
+static void selectObject(const shared_ptr<GameObject>& go) {
+    for (auto& g : gameObjects) g->isSelected = false;
+    selectedGameObject = go;
+    if (selectedGameObject) selectedGameObject->isSelected = true;
+}
+
 static void handle_input(double deltaTime) {
     SDL_Event event;
     
@@ -478,7 +463,6 @@ static void handle_input(double deltaTime) {
                 std::string copied = copyIntoAssets(droppedFile, target);
                 if (!copied.empty()) {
                     AssetDatabase::instance().importAsset(copied);
-                    AssetDatabase::instance().refresh();
                     LOG_INFO(std::string("Imported into Assets: ") + copied);
                 } else {
                     LOG_ERROR(std::string("Failed to import into Assets: ") + droppedFile);
@@ -534,6 +518,12 @@ static void handle_input(double deltaTime) {
         if (event.type == SDL_EVENT_MOUSE_BUTTON_DOWN && event.button.button == SDL_BUTTON_LEFT && insideScene && !ImGui::GetIO().WantCaptureMouse) {
             float localX = event.button.x - sceneBounds.x;
             float localY = event.button.y - sceneBounds.y;
+
+            // Con GPU picking el resultado llega en poll, una o dos frames despues
+            if (GpuPicker::instance().isEnabled()) {
+                GpuPicker::instance().request((int)localX, (int)localY);
+                continue;
+            }
   
             mat4 view = editorCamera.view();
             double aspect = (sceneBounds.h > 0) ? sceneBounds.w / sceneBounds.h : 1.0;
@@ -541,30 +531,14 @@ static void handle_input(double deltaTime) {
    
             Ray ray = getRayFromMouse((int)localX, (int)localY, editorCamera.transform.pos(), proj, view, (int)sceneBounds.w, (int)sceneBounds.h);
 
-            auto candidates = mainOctree.queryRay(ray);
-            shared_ptr<GameObject> closest = nullptr;
-            double closestDist = std::numeric_limits<double>::max();
-       
-            for (auto& go : candidates) {
-            if (!go->mesh) continue;
-                mat4 worldMatrix = computeWorldMatrix(go.get());
-                AABB worldAABB = go->mesh->getWorldAABB(worldMatrix);
-                double t;
-                if (ray.intersectsAABB(worldAABB, t)) {
-                    if (t < closestDist) { closestDist = t; closest = go; }
-                }
-            }
-  
-            for(auto& g : gameObjects) g->isSelected = false;
-            if (closest) {
-                closest->isSelected = true;
-                selectedGameObject = closest;
-            } else {
-                selectedGameObject = nullptr;
-            }
+            GameObject* closest = mainOctree.raycastClosest(ray);
+            selectObject(findSceneObject(closest));
         }
     }
 
+    const GameObject* picked = nullptr;
+    if (GpuPicker::instance().poll(picked)) selectObject(findSceneObject(picked));
+
     // Update camera - Solo si en Scene
     if (allowEditorInput && insideScene) {
       editorCamera.update(deltaTime);
@@ -578,6 +552,9 @@ static void render() {
 
     int winW, winH;
     SDL_GetWindowSize(window, &winW, &winH);
+    Renderer::instance().beginFrame();
+    Renderer::instance().setStencilSelection(OutlinePass::instance().isEnabled());
+    DebugDraw::instance().beginFrame();
     
     // ============================================
     // 1. SCENE VIEW (Editor Camera)
@@ -602,7 +579,7 @@ static void render() {
     
     sceneFramebuffer.Bind();
     glClearColor(0.2f, 0.2f, 0.2f, 1.0f); // Dark Gray Grid Bg
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
     glEnable(GL_DEPTH_TEST);
     
     // Setup Editor View using Camera class
@@ -618,31 +595,43 @@ static void render() {
     glLoadMatrixd(glm::value_ptr(projEditor));
     glMatrixMode(GL_MODELVIEW);
     
-    draw_floorGrid(20, 1.0);
+    const mat4 viewProjEditor = projEditor * viewEditor;
+    DebugDraw::instance().drawGrid(20, 1.0, glm::u8vec3(100, 100, 100), viewProjEditor);
     
     // Draw Objects (Editor Pass)
     Frustum editorFrustum;
     editorFrustum.extractFromCamera(projEditor * viewEditor);
     
-    if (editor.isFrustumCullingEnabled()) {
-        auto potentials = mainOctree.queryFrustum(editorFrustum);
-        for (const auto& go : potentials) if (go->mesh) go->draw(); 
-    } else {
-        for (const auto& go : gameObjects) go->draw();
-    }
+    drawScene(editorFrustum, viewEditor, projEditor);
+    OutlinePass::instance().draw(sceneFramebuffer);
     
+    // Placeholders de modelos que aun se estan cargando
+    for (const auto& go : gameObjects) {
+        if (!go->meshLoading) continue;
+        const vec3 p = vec3(go->worldMatrix()[3]);
+        drawAABB(AABB(p - vec3(0.5), p + vec3(0.5)), glm::u8vec3(160, 160, 160));
+    }
+
     // Draw Debug Gizmos (AABBs, Frustums, etc.) - ONLY IN SCENE VIEW
     if (editor.shouldShowAABBs()) {
         mainOctree.drawDebug();
         for (const auto& go : gameObjects) {
             if (go->mesh && go->mesh->localAABB.isValid()) {
-                mat4 m = computeWorldMatrix(go.get());
-                AABB worldAABB = go->mesh->getWorldAABB(m);
+                const AABB& worldAABB = go->worldAABB();
                 glm::u8vec3 color = go->isSelected ? glm::u8vec3(255, 255, 0) : glm::u8vec3(255, 0, 0);
                 drawAABB(worldAABB, color);
             }
         }
     }
+    DebugDraw::instance().flush(viewProjEditor);
+
+    // Pick pendiente: IDs de los objetos bajo el cursor, solo en ese pixel
+    GpuPicker& picker = GpuPicker::instance();
+    if (picker.wantsPass()) {
+        static vector<GameObject*> pickCandidates;
+        collectVisible(picker.pixelFrustum(viewProjEditor, sceneFramebuffer.GetWidth(), sceneFramebuffer.GetHeight()), pickCandidates);
+        picker.renderPass(sceneFramebuffer, viewProjEditor, pickCandidates);
+    }
     
     sceneFramebuffer.Unbind();
     
@@ -660,7 +649,7 @@ static void render() {
 
     gameFramebuffer.Bind();
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // Black for Game
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
     
     if (mainCamera && mainCamera->camera.enabled) {
         glEnable(GL_DEPTH_TEST);
@@ -680,12 +669,9 @@ static void render() {
         Frustum gameFrustum;
         gameFrustum.extractFromCamera(projGame * viewGame);
         
-        if (editor.isFrustumCullingEnabled()) {
-            auto potentials = mainOctree.queryFrustum(gameFrustum);
-            for (const auto& go : potentials) if (go->mesh) go->draw(); 
-        } else {
-            for (const auto& go : gameObjects) go->draw();
-        }
+        drawScene(gameFrustum, viewGame, projGame);
+        OutlinePass::instance().draw(gameFramebuffer);
+        DebugDraw::instance().flush(projGame * viewGame); // Normales de debug
     }
     gameFramebuffer.Unbind();
     
@@ -718,7 +704,7 @@ static void render() {
     else if (!isPlaying && lastPlaying) {
         // Stop
         cout << "Stopping Simulation... Restoring scene..." << endl;
-        SceneSerializer::LoadScene(tempScenePath, gameObjects);
+        SceneSerializer::LoadScene(tempScenePath, gameObjects, &mainOctree);
         
         mainCamera = nullptr;
         for(auto& go : gameObjects) if(go->camera.enabled) mainCamera = go;
@@ -727,8 +713,7 @@ static void render() {
             mainCamera->transform = storedEditorCamera.transform;
             mainCamera->camera = storedEditorCamera.camComp;
         }
-        mainOctree.clear();
-        for(auto& go : gameObjects) mainOctree.insert(go);
+        mainOctree.rebuild(gameObjects);
         selectedGameObject = nullptr;
     }
     lastPlaying = isPlaying;
@@ -737,6 +722,7 @@ static void render() {
     s_Step = false;
     }
 
+    Renderer::instance().endFrame();
     SDL_GL_SwapWindow(window);
 }
 
@@ -764,8 +750,12 @@ int main(int argc, char* argv[]) {
         cout << "SDL could not be initialized! " << SDL_GetError() << endl;
         return EXIT_FAILURE;
     }
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
+    // --legacy fuerza el pipeline fijo; si no, se intenta un contexto 3.3 para el renderer GLSL
+    RenderBackend requestedBackend = RenderBackend::Shader;
+    for (int i = 1; i < argc; ++i) {
+        if (string(argv[i]) == "--legacy") requestedBackend = RenderBackend::Legacy;
+    }
+
     SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
     SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
     int screenWidth = 1280, screenHeight = 720;
@@ -774,15 +764,42 @@ int main(int argc, char* argv[]) {
         cout << "Window could not be created! " << SDL_GetError() << endl;
         return EXIT_FAILURE;
     }
-    glContext = SDL_GL_CreateContext(window);
+    if (requestedBackend == RenderBackend::Shader) {
+        // Compatibilidad y no core: los gizmos de debug aun usan modo inmediato
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_COMPATIBILITY);
+        glContext = SDL_GL_CreateContext(window);
+        if (!glContext) {
+            cout << "OpenGL 3.3 compatibility context not available, falling back to 2.1" << endl;
+            requestedBackend = RenderBackend::Legacy;
+        }
+    }
+    if (!glContext) {
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, 0);
+        glContext = SDL_GL_CreateContext(window);
+    }
     editor.init(window, glContext);
     editor.setScene(&gameObjects, &selectedGameObject);
     editor.setScene(&gameObjects, &selectedGameObject);
+    editor.setOctree(&mainOctree);
+    editor.setTransformHierarchy(&sceneTransforms);
+    editor.setStaticBatcher(&staticBatches);
     if (!glContext) {
         cout << "OpenGL context could not be created!" << endl;
         return EXIT_FAILURE;
     }
     init_opengl();
+    Renderer::instance().init(requestedBackend);
+    Renderer::instance().setStaticBatcher(&staticBatches);
+    DebugDraw::instance().init();
+    if (GpuPicker::instance().init()) sceneFramebuffer.EnableIdAttachment(true);
+    if (OutlinePass::instance().init()) {
+        sceneFramebuffer.EnableDepthStencilTexture(true);
+        gameFramebuffer.EnableDepthStencilTexture(true);
+    }
     
     // Initialize AssetDatabase
     std::string assetsPath = getAssetsPath();
@@ -810,15 +827,33 @@ int main(int argc, char* argv[]) {
         lastTime = currentTime;
 
         handle_input(deltaTime);
+        AssetDatabase::instance().pollImport();
+        AsyncModelLoader::instance().update();
+        ResourceManager::instance().collect();
+        sceneTransforms.sync(gameObjects);
+        sceneTransforms.update();
+        staticBatches.sync(gameObjects);
         render();
         if (editor.wantsQuit()) running = false;
         SDL_Delay(1);
     }
     gameObjects.clear();
+    sceneTransforms.clear();
+    staticBatches.clear();
+    mainOctree.clear();
+    Renderer::instance().setStaticBatcher(nullptr);
+    selectedGameObject = nullptr;
+    // Con el contexto GL vivo: suelta sus texturas (checker, Restore) e ImGui
+    editor.shutdown();
+    ResourceManager::instance().shutdown();
+    AsyncModelLoader::instance().shutdown();
+    OutlinePass::instance().shutdown();
+    GpuPicker::instance().shutdown();
+    DebugDraw::instance().shutdown();
+    Renderer::instance().shutdown();
     AssetDatabase::instance().shutdown();
     SDL_GL_DestroyContext(glContext);
     SDL_DestroyWindow(window);
-    editor.shutdown();
     SDL_Quit();
     return EXIT_SUCCESS;
 }
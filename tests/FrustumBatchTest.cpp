@@ -0,0 +1,105 @@
+// Equivalencia de los kernels SIMD de FrustumBatch con el escalar y con
+// Frustum::containsAABB, sobre frustums y cajas aleatorios
+#include "FrustumBatch.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+const char* name(FrustumBatch::Kernel k) {
+    switch (k) {
+    case FrustumBatch::Kernel::AVX:  return "AVX";
+    case FrustumBatch::Kernel::SSE2: return "SSE2";
+    default:                         return "Scalar";
+    }
+}
+
+// Planos que rodean el origen a distancias variadas: parte de las cajas queda
+// dentro, parte fuera y parte cortando
+Frustum randomFrustum(std::mt19937& rng) {
+    std::uniform_real_distribution<double> dir(-1.0, 1.0);
+    std::uniform_real_distribution<double> dist(1.0, 12.0);
+    Frustum f;
+    for (int p = 0; p < Frustum::COUNT; ++p) {
+        vec3 n(dir(rng), dir(rng), dir(rng));
+        if (glm::length(n) < 1e-3) n = vec3(0, 1, 0);
+        f.planes[p] = Plane(n, dist(rng));
+    }
+    return f;
+}
+
+AABB randomBox(std::mt19937& rng) {
+    std::uniform_real_distribution<double> pos(-15.0, 15.0);
+    std::uniform_real_distribution<double> ext(0.0, 3.0);
+    const vec3 c(pos(rng), pos(rng), pos(rng));
+    const vec3 h(ext(rng), ext(rng), ext(rng));
+    return AABB(c - h, c + h);
+}
+
+void expectEqual(const char* what, FrustumBatch::Kernel k, const std::vector<uint8_t>& got,
+                 const std::vector<uint8_t>& expected, int round) {
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (got[i] != expected[i]) {
+            std::printf("FAIL %s %s: round %d, box %zu: %d != %d\n", name(k), what, round, i, got[i], expected[i]);
+            ++failures;
+            return;
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(1234);
+    const FrustumBatch::Kernel kernels[] = { FrustumBatch::Kernel::Scalar, FrustumBatch::Kernel::SSE2, FrustumBatch::Kernel::AVX };
+    std::uniform_int_distribution<int> boxCount(0, 1027);   // Incluye restos que no llenan un registro
+    std::uniform_int_distribution<unsigned> mask(0, Frustum::ALL_PLANES);
+
+    int tested[3] = { 0, 0, 0 };
+    for (int round = 0; round < 200; ++round) {
+        const Frustum frustum = randomFrustum(rng);
+        AABBBatch batch;
+        std::vector<AABB> boxes;
+        const int n = boxCount(rng);
+        for (int i = 0; i < n; ++i) {
+            boxes.push_back(randomBox(rng));
+            batch.push(boxes.back());
+        }
+
+        // Todos los planos: referencia Frustum::containsAABB
+        std::vector<uint8_t> reference(boxes.size());
+        for (size_t i = 0; i < boxes.size(); ++i) reference[i] = frustum.containsAABB(boxes[i]) ? 1 : 0;
+        std::vector<uint8_t> scalar;
+        FrustumBatch::cullScalar(frustum, batch, scalar);
+        expectEqual("cullScalar vs containsAABB", FrustumBatch::Kernel::Scalar, scalar, reference, round);
+
+        // Subconjunto de planos (lo que deja el octree): referencia cullScalar
+        const unsigned planeMask = mask(rng);
+        std::vector<uint8_t> scalarMasked;
+        FrustumBatch::cullScalar(frustum, batch, scalarMasked, planeMask);
+
+        for (int k = 0; k < 3; ++k) {
+            std::vector<uint8_t> visible;
+            if (!FrustumBatch::cullWith(kernels[k], frustum, batch, visible)) continue;
+            ++tested[k];
+            expectEqual("vs containsAABB", kernels[k], visible, reference, round);
+            visible.clear();
+            FrustumBatch::cullWith(kernels[k], frustum, batch, visible, planeMask);
+            expectEqual("vs cullScalar (plane mask)", kernels[k], visible, scalarMasked, round);
+        }
+    }
+
+    for (int k = 0; k < 3; ++k) {
+        if (tested[k]) std::printf("%s: %d rounds\n", name(kernels[k]), tested[k]);
+        else std::printf("%s: not supported here, skipped\n", name(kernels[k]));
+    }
+    if (failures) {
+        std::printf("%d failures\n", failures);
+        return 1;
+    }
+    std::printf("All kernels match\n");
+    return 0;
+}